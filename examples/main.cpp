@@ -33,7 +33,8 @@ using namespace std;
 using namespace smd::fbt;
 
 using timeData_t = float;
-using nodePtr_t  = shared_ptr< node_i< timeData_t > >;
+using tree_t     = tree_c< timeData_t >;
+using treePtr_t  = unique_ptr< tree_t >;
 using builder_t  = builder_c< timeData_t >;
 
 #define DO( name, code )        .mDo( name, []( timeData_t ) code )
@@ -44,10 +45,10 @@ using builder_t  = builder_c< timeData_t >;
 #define BUILD                   .mBuild()
 
 //==============================================================================================================================
-nodePtr_t startUp( void ) {
+treePtr_t startUp( void ) {
     builder_t builder;
 
-    nodePtr_t pTree {
+    treePtr_t pTree {
         builder
             SEQUENCE( "My-Sequence" )
                 DO( "Action-1", {
@@ -88,16 +89,16 @@ nodePtr_t startUp( void ) {
 }
 
 //==============================================================================================================================
-void update( nodePtr_t pTree, timeData_t timeData ) {
-    pTree->mTick( timeData );
+void update( tree_t& tree, timeData_t timeData ) {
+    tree.mTick( timeData );
 }
 
 //==============================================================================================================================
 int main( void ) try {
-    nodePtr_t pTree { startUp() };
+    treePtr_t pTree { startUp() };
 
-    update( pTree, 0.1f );
-    update( pTree, 0.3f );
+    update( *pTree, 0.1f );
+    update( *pTree, 0.3f );
 
     return 0;
 
@@ -26,11 +26,34 @@
 #pragma once
 
 #include "fluent-behaviour-tree/common.hpp"
+#include "fluent-behaviour-tree/statuslanes.hpp"
+#include "fluent-behaviour-tree/snapshot.hpp"
+#include "fluent-behaviour-tree/profiler_c.hpp"
+#include "fluent-behaviour-tree/resourceallocator_c.hpp"
+#include "fluent-behaviour-tree/arena_c.hpp"
+#include "fluent-behaviour-tree/scratch_c.hpp"
 #include "fluent-behaviour-tree/node_i.hpp"
+#include "fluent-behaviour-tree/activepath_c.hpp"
 #include "fluent-behaviour-tree/parentnode_i.hpp"
 #include "fluent-behaviour-tree/actionnode_c.hpp"
+#include "fluent-behaviour-tree/batchcondition_c.hpp"
+#include "fluent-behaviour-tree/conditionnode_c.hpp"
 #include "fluent-behaviour-tree/inverternode_c.hpp"
+#include "fluent-behaviour-tree/lazysubtreenode_c.hpp"
 #include "fluent-behaviour-tree/parallelnode_c.hpp"
+#include "fluent-behaviour-tree/reactiveselectornode_c.hpp"
 #include "fluent-behaviour-tree/selectornode_c.hpp"
 #include "fluent-behaviour-tree/sequencenode_c.hpp"
+#include "fluent-behaviour-tree/subtreenode_c.hpp"
+#include "fluent-behaviour-tree/waitnode_c.hpp"
+#include "fluent-behaviour-tree/tree_c.hpp"
+#include "fluent-behaviour-tree/structure.hpp"
+#include "fluent-behaviour-tree/instance_c.hpp"
+#include "fluent-behaviour-tree/library_c.hpp"
+#include "fluent-behaviour-tree/parallelticker_c.hpp"
+#include "fluent-behaviour-tree/partitionedticker_c.hpp"
+#include "fluent-behaviour-tree/scheduler_c.hpp"
 #include "fluent-behaviour-tree/builder_c.hpp"
+#include "fluent-behaviour-tree/optimizer_c.hpp"
+#include "fluent-behaviour-tree/codegen_c.hpp"
+#include "fluent-behaviour-tree/image_c.hpp"
@@ -35,39 +35,66 @@ namespace smd::fbt {
 //==============================================================================================================================
 template< typename timeData_t >
 class actionNode_c final : public node_i< timeData_t > {
-    using node_t     = node_i< timeData_t >;
-    using function_t = std::function< status_t( timeData_t ) >;
+    using node_t    = node_i< timeData_t >;
+    using context_t = typename node_t::context_t;
 
 public:
-    inline status_t mTick( timeData_t timeData ) override;
+    using function_t        = std::function< status_t( param_t< timeData_t > ) >;
+    using contextFunction_t = std::function< status_t( const context_t& ) >; // For leaves needing the agent or the state.
+
+    inline status_t mTick( context_t& context ) const noexcept override;
+
+    inline bool mcHasSameFunction( const actionNode_c& cOther ) const noexcept; // See 'isSameFunction'.
 
     actionNode_c& operator=( const actionNode_c& ) = delete;
     actionNode_c& operator=( actionNode_c&& )      noexcept = delete;
-    inline        actionNode_c( const std::string& cName, const function_t& cFunction );
+    inline        actionNode_c( std::string_view cName, function_t function );
+    inline        actionNode_c( std::string_view cName, contextFunction_t function );
     inline        actionNode_c( const actionNode_c& cNode );
-                  actionNode_c( actionNode_c&& )   noexcept = delete;
-                  ~actionNode_c( void )            = default;
+    inline        actionNode_c( actionNode_c&& node );
+                  ~actionNode_c( void ) = default;
 
 private:
-    const function_t mcFunction; // Function to invoke for the action.
+    function_t        mFunction;        // Function to invoke for the action.
+    contextFunction_t mContextFunction; // Or this one if it takes the context.
 };
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline status_t actionNode_c< timeData_t >::mTick( timeData_t timeData ) {
-    return mcFunction( timeData );
+inline status_t actionNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    return mContextFunction ? mContextFunction( context ) : mFunction( context.timeData );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool actionNode_c< timeData_t >::mcHasSameFunction( const actionNode_c& cOther ) const noexcept {
+    return isSameFunction( mFunction, cOther.mFunction ) && isSameFunction( mContextFunction, cOther.mContextFunction );
 }
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline actionNode_c< timeData_t >::actionNode_c( const std::string& cName, const function_t& cFunction ) :
-    node_t( cName ),
-    mcFunction( cFunction ) {}
+inline actionNode_c< timeData_t >::actionNode_c( std::string_view cName, function_t function ) :
+    node_t( nodeKind_t::ACTION, cName ),
+    mFunction( move( function ) ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline actionNode_c< timeData_t >::actionNode_c( std::string_view cName, contextFunction_t function ) :
+    node_t( nodeKind_t::ACTION, cName ),
+    mContextFunction( move( function ) ) {}
 
 //==============================================================================================================================
 template< typename timeData_t >
 inline actionNode_c< timeData_t >::actionNode_c( const actionNode_c& cNode ) :
     node_t( cNode ),
-    mcFunction( cNode.mcFunction ) {}
+    mFunction( cNode.mFunction ),
+    mContextFunction( cNode.mContextFunction ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline actionNode_c< timeData_t >::actionNode_c( actionNode_c&& node ) :
+    node_t( std::move( node ) ),
+    mFunction( std::move( node.mFunction ) ),
+    mContextFunction( std::move( node.mContextFunction ) ) {}
 
 } // namespace smd::fbt
@@ -0,0 +1,224 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Gives a tree memory semantics: a tick resumes right at the running leaf instead of descending from the root through every
+// composite, and only unwinds upward when the leaf finishes. The path from the root to the running leaf is kept as a small
+// stack of nodes, rebuilt from the state block after a tick that changed it, so it never has to be stored in the state.
+//
+// A composite on the path resumes in its running child by 'node_i::mcGetResumeChild' and continues after it by
+// 'node_i::mResume', e.g. a sequence goes on with the next child when the running one succeeds. Composites that must tick all
+// of their children again (parallel, reactive selector) and paths deeper than 'cMaxDepth' make the tick start at the root.
+//
+// The path also keeps the traversal of a time-sliced tick that ran out of budget: then it ends at the composite that
+// suspended the tick, and the next tick continues that composite after the child it ticked last, whether the tree has memory
+// or not. Edits, resets and restores drop a suspended traversal.
+//==============================================================================================================================
+template< typename timeData_t >
+class activePath_c final {
+    using node_t    = node_i< timeData_t >;
+    using context_t = tickContext_t< timeData_t >;
+
+public:
+    static constexpr uint32_t cMaxDepth { 32 };
+
+    inline status_t mTick( const node_t& cRoot, context_t& context, bool hasMemory ) noexcept;
+    inline void     mInvalidate( void )                                              noexcept; // After the state changed outside of 'mTick'.
+
+    inline uint32_t      mcGetDepth( void )    const noexcept; // Zero if no leaf is running and no tick is suspended.
+    inline const node_t* mcGetLeaf( void )     const noexcept; // Or null if no leaf is running.
+    inline bool          mcIsSuspended( void ) const noexcept; // Whether the last tick ran out of budget.
+
+    activePath_c& operator=( const activePath_c& ) = default;
+    activePath_c& operator=( activePath_c&& )      noexcept = default;
+                  activePath_c( void )                = default;
+                  activePath_c( const activePath_c& ) = default;
+                  activePath_c( activePath_c&& )      noexcept = default;
+                  ~activePath_c( void )               = default;
+
+private:
+    struct entry_t final {
+        const node_t* pNode;
+        uint32_t      stateBase; // Offset of the state block the node ticks in, non-zero within spliced sub-trees.
+        uint32_t      iChild;    // Child of the node on the path.
+    };
+
+    inline status_t mUnwind( uint32_t iEntry, status_t status, context_t& context, uint8_t* pState ) const noexcept;
+    inline void     mBuild( const node_t& cRoot, context_t& context, bool hasMemory ) noexcept;
+
+    std::array< entry_t, cMaxDepth > mEntries {};                      // From the root to the running leaf.
+    uint32_t                         mDepth { 0 };                     // Number of entries in use.
+    bool                             mIsValid { false };               // Whether the path matches the state block.
+    bool                             mIsSuspended { false };           // Whether the path ends at a suspended composite.
+    status_t                         mDoneStatus { status_t::SUCCESS }; // Status the suspended composite continues with.
+};
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t activePath_c< timeData_t >::mTick( const node_t& cRoot, context_t& context, bool hasMemory ) noexcept {
+    if ( !mIsValid ) {
+        mBuild( cRoot, context, hasMemory );
+    }
+
+    uint8_t* const cpState { context.pState };
+    status_t       status;
+
+    if ( mIsSuspended ) {
+        const entry_t& cEntry = mEntries[ mDepth - 1 ];
+
+        context.pState = cpState + cEntry.stateBase;
+        status         = mUnwind( mDepth - 1, cEntry.pNode->mResume( context, cEntry.iChild, mDoneStatus ), context, cpState );
+    } else if ( mDepth ) {
+        const entry_t& cLeaf = mEntries[ mDepth - 1 ];
+
+        context.pState = cpState + cLeaf.stateBase;
+        status         = cLeaf.pNode->mTick( context );
+
+        if ( status == status_t::RUNNING ) {
+            context.pState = cpState;
+            return status;
+        }
+
+        status = mUnwind( mDepth - 1, status, context, cpState );
+    } else {
+        status = cRoot.mTick( context );
+    }
+
+    context.pState = cpState;
+
+    if ( status == status_t::RUNNING ) {
+        mBuild( cRoot, context, hasMemory );
+    } else {
+        mDepth       = 0;
+        mIsSuspended = false;
+    }
+
+    return status;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void activePath_c< timeData_t >::mInvalidate( void ) noexcept {
+    mIsValid     = false;
+    mIsSuspended = false;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t activePath_c< timeData_t >::mcGetDepth( void ) const noexcept {
+    return mDepth;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto activePath_c< timeData_t >::mcGetLeaf( void ) const noexcept ->const node_t* {
+    return mDepth && !mIsSuspended ? mEntries[ mDepth - 1 ].pNode : nullptr;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool activePath_c< timeData_t >::mcIsSuspended( void ) const noexcept {
+    return mIsSuspended;
+}
+
+//==============================================================================================================================
+// Continues the ancestors of entry 'iEntry' after it returned 'status', up to the root or to the first one still running.
+// 'pState' is the state block of the whole tree.
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t activePath_c< timeData_t >::mUnwind( uint32_t iEntry, status_t status, context_t& context,
+                                                     uint8_t* pState ) const noexcept {
+    while ( iEntry-- > 0 && status != status_t::RUNNING ) {
+        const entry_t& cEntry = mEntries[ iEntry ];
+
+        context.pState = pState + cEntry.stateBase;
+        status         = cEntry.pNode->mResume( context, cEntry.iChild, status );
+    }
+
+    return status;
+}
+
+//==============================================================================================================================
+// Follows the running children from the root down to a leaf, or to the composite that suspended the tick. Without memory only
+// a suspended traversal is kept, the path stays empty if it doesn't reach its end.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void activePath_c< timeData_t >::mBuild( const node_t& cRoot, context_t& context, bool hasMemory ) noexcept {
+    const node_t* const cpSuspended { context.pSlice ? context.pSlice->pSuspended : nullptr };
+    uint8_t* const      cpState { context.pState };
+    const node_t*       cpNode { &cRoot };
+    uint32_t            stateBase { 0 };
+
+    mDepth       = 0;
+    mIsValid     = true;
+    mIsSuspended = false;
+
+    if ( !hasMemory && !cpSuspended ) {
+        return;
+    }
+
+    for ( uint32_t depth = 0; depth < cMaxDepth; ++depth ) {
+        if ( cpNode == cpSuspended ) {
+            mEntries[ depth ] = { cpNode, stateBase, context.pSlice->iDone };
+            mDepth            = depth + 1;
+            mIsSuspended      = true;
+            mDoneStatus       = context.pSlice->doneStatus;
+            break;
+        }
+
+        if ( !cpNode->mcIsParent() ) {
+            if ( hasMemory ) {
+                mEntries[ depth ] = { cpNode, stateBase, node_t::cNoChild };
+                mDepth            = depth + 1;
+            }
+            break;
+        }
+
+        context.pState = cpState + stateBase;
+        const uint32_t cChild { cpNode->mcGetResumeChild( context ) };
+
+        if ( cChild == node_t::cNoChild ) {
+            break;
+        }
+
+        mEntries[ depth ] = { cpNode, stateBase, cChild };
+
+        if ( cpNode->mcKind == nodeKind_t::SUBTREE ) {
+            stateBase += cpNode->mcGetStateOffset();
+        }
+
+        cpNode = cpNode->mcGetChild( cChild );
+    }
+
+    context.pState = cpState;
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,120 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "resourceallocator_c.hpp"
+
+#include <new>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Bump allocator of a runtime thread. Every allocation starts on its own cache line and takes whole lines, so two allocations
+// never share a line. Blocks are obtained from the heap but are written first by the thread that allocates from the arena,
+// so with the usual first-touch policy their pages land on the NUMA node of that thread. Nothing is freed until the arena is
+// destroyed, released allocations are only counted so the owner can tell when to rebuild its data in a fresh arena.
+//==============================================================================================================================
+class arena_c final {
+public:
+    static constexpr size_t cLineSize { 64 };
+    static constexpr size_t cAlign    { cLineSize };
+
+    inline void* mAllocate( size_t size );         // Aligned to 'cLineSize'.
+    inline void  mRelease( size_t size ) noexcept; // Of an allocation no longer used.
+
+    inline size_t mcGetNumBytes( void )         const noexcept; // Handed out so far, rounded up to whole lines.
+    inline size_t mcGetNumReleasedBytes( void ) const noexcept; // Of the bytes handed out.
+
+    arena_c&        operator=( const arena_c& ) = delete;
+    arena_c&        operator=( arena_c&& )      = delete;
+    explicit inline arena_c( size_t blockSize = 64 * 1024 );
+                    arena_c( const arena_c& ) = delete;
+                    arena_c( arena_c&& )      = delete;
+    inline          ~arena_c( void );
+
+private:
+    std::vector< uint8_t* > mBlocks;         // All blocks, the last one is being bumped.
+    size_t                  mBlockSize;      // Size of a regular block, larger allocations get a block of their own.
+    size_t                  mOffset { 0 };   // Free space of the last block starts here.
+    size_t                  mNumBytes { 0 }; // Handed out so far.
+    size_t                  mNumReleasedBytes { 0 };
+};
+
+//==============================================================================================================================
+// Adapts an arena to the standard allocator interface, e.g. for the state block of 'instance_c'. Deallocation only releases.
+//==============================================================================================================================
+template< typename type_t >
+using arenaAllocator_c = resourceAllocator_c< type_t, arena_c >;
+
+//==============================================================================================================================
+inline void* arena_c::mAllocate( size_t size ) {
+    const size_t cSize { ( std::max< size_t >( size, 1 ) + cLineSize - 1 ) / cLineSize * cLineSize };
+
+    if ( mBlocks.empty() || mOffset + cSize > mBlockSize ) {
+        // A large allocation gets a block of its own, it's used up at once so the next one starts a new block.
+        mBlocks.reserve( mBlocks.size() + 1 );
+        mBlocks.push_back( static_cast< uint8_t* >(
+            ::operator new( std::max( cSize, mBlockSize ), std::align_val_t { cLineSize } ) ) );
+        mOffset = 0;
+    }
+
+    void* const cpMemory { mBlocks.back() + mOffset };
+
+    mOffset   += cSize;
+    mNumBytes += cSize;
+
+    return cpMemory;
+}
+
+//==============================================================================================================================
+inline void arena_c::mRelease( size_t size ) noexcept {
+    mNumReleasedBytes += ( std::max< size_t >( size, 1 ) + cLineSize - 1 ) / cLineSize * cLineSize;
+}
+
+//==============================================================================================================================
+inline size_t arena_c::mcGetNumBytes( void ) const noexcept {
+    return mNumBytes;
+}
+
+//==============================================================================================================================
+inline size_t arena_c::mcGetNumReleasedBytes( void ) const noexcept {
+    return mNumReleasedBytes;
+}
+
+//==============================================================================================================================
+inline arena_c::arena_c( size_t blockSize ) :
+    mBlockSize( ( std::max< size_t >( blockSize, cLineSize ) + cLineSize - 1 ) / cLineSize * cLineSize ) {
+}
+
+//==============================================================================================================================
+inline arena_c::~arena_c( void ) {
+    for ( uint8_t* pBlock : mBlocks ) {
+        ::operator delete( pBlock, std::align_val_t { cLineSize } );
+    }
+}
+
+} // namespace smd::fbt
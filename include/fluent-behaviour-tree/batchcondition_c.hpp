@@ -0,0 +1,149 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "statuslanes.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// A condition evaluated for a whole batch of agents at once. The kernel receives a contiguous array of agent states and writes
+// one bit per agent into a zeroed mask (bit 'i % 64' of word 'i / 64' is set when the condition holds for agent 'i'), so
+// threshold checks over plain arrays can be vectorized by the compiler. Leaves created with 'builder_c::mBatchCondition()'
+// only read the bit of their agent, which is found by where 'pAgent' of the tick points within the evaluated states, so the
+// tree can be shared by the instances of all agents. Agents outside of the last evaluated batch fail the condition.
+//==============================================================================================================================
+template< typename agentState_t >
+class batchCondition_c final {
+    using kernel_t = std::function< void( const agentState_t* pStates, size_t numStates, uint64_t* pMask ) >;
+
+public:
+    const std::string mcName; // Name of the condition.
+
+    inline void mEvaluate( const agentState_t* pStates, size_t numStates );
+
+    inline bool            mcTest( size_t iAgent )       const noexcept; // False for agents out of the batch.
+    inline status_t        mcGetStatus( size_t iAgent )  const noexcept;
+    inline statusLanes_t   mcGetLanes( size_t iWord )    const noexcept;
+    inline size_t          mcFind( const void* cpAgent ) const noexcept; // Index of the state or 'cNoAgent'.
+    inline const uint64_t* mcGetMask( void )             const noexcept;
+    inline size_t          mcGetNumStates( void )        const noexcept;
+
+    static constexpr size_t cNoAgent { SIZE_MAX };
+
+    batchCondition_c& operator=( const batchCondition_c& ) = delete;
+    batchCondition_c& operator=( batchCondition_c&& )      noexcept = delete;
+    inline            batchCondition_c( std::string_view cName, const kernel_t& cKernel );
+                      batchCondition_c( const batchCondition_c& ) = delete;
+                      batchCondition_c( batchCondition_c&& )      noexcept = delete;
+                      ~batchCondition_c( void )                   = default;
+
+private:
+    const kernel_t          mcKernel;             // Function to evaluate the condition for the batch.
+    std::vector< uint64_t > mMask;                // Result of the last evaluation, one bit per agent.
+    size_t                  mNumStates;           // Number of agents in the last evaluation.
+    const agentState_t*     mpStates { nullptr }; // States of the last evaluation, only compared with, never read.
+};
+
+//==============================================================================================================================
+// Evaluates the condition for all agents, must be called before ticking the trees that read it.
+//==============================================================================================================================
+template< typename agentState_t >
+inline void batchCondition_c< agentState_t >::mEvaluate( const agentState_t* pStates, size_t numStates ) {
+    mMask.assign( ( numStates + 63 ) / 64, 0 );
+    mNumStates = numStates;
+    mpStates   = pStates;
+
+    if ( numStates ) {
+        mcKernel( pStates, numStates, mMask.data() );
+    }
+}
+
+//==============================================================================================================================
+template< typename agentState_t >
+inline bool batchCondition_c< agentState_t >::mcTest( size_t iAgent ) const noexcept {
+    return iAgent < mNumStates && ( ( mMask[ iAgent >> 6 ] >> ( iAgent & 63 ) ) & 1 );
+}
+
+//==============================================================================================================================
+template< typename agentState_t >
+inline status_t batchCondition_c< agentState_t >::mcGetStatus( size_t iAgent ) const noexcept {
+    return mcTest( iAgent ) ? status_t::SUCCESS : status_t::FAILURE;
+}
+
+//==============================================================================================================================
+// Result for agents '[ iWord * 64, iWord * 64 + 64 )' as status lanes, lanes past the last agent are RUNNING.
+//==============================================================================================================================
+template< typename agentState_t >
+inline statusLanes_t batchCondition_c< agentState_t >::mcGetLanes( size_t iWord ) const noexcept {
+    if ( iWord >= mMask.size() ) {
+        return { 0, 0 };
+    }
+
+    const size_t   cNumValid { mNumStates - iWord * 64 };
+    const uint64_t cValid    { cNumValid >= 64 ? ~uint64_t( 0 ) : ( uint64_t( 1 ) << cNumValid ) - 1 };
+
+    return { mMask[ iWord ], ~mMask[ iWord ] & cValid };
+}
+
+//==============================================================================================================================
+// The agent is compared by address only, so any pointer may be passed, e.g. 'pAgent' of an instance with another kind of agent.
+//==============================================================================================================================
+template< typename agentState_t >
+inline size_t batchCondition_c< agentState_t >::mcFind( const void* cpAgent ) const noexcept {
+    const uintptr_t cAddress { reinterpret_cast< uintptr_t >( cpAgent ) };
+    const uintptr_t cBegin   { reinterpret_cast< uintptr_t >( mpStates ) };
+
+    if ( !mpStates || cAddress < cBegin || ( cAddress - cBegin ) % sizeof( agentState_t ) ) {
+        return cNoAgent;
+    }
+
+    const size_t cIndex { ( cAddress - cBegin ) / sizeof( agentState_t ) };
+
+    return cIndex < mNumStates ? cIndex : cNoAgent;
+}
+
+//==============================================================================================================================
+template< typename agentState_t >
+inline const uint64_t* batchCondition_c< agentState_t >::mcGetMask( void ) const noexcept {
+    return mMask.data();
+}
+
+//==============================================================================================================================
+template< typename agentState_t >
+inline size_t batchCondition_c< agentState_t >::mcGetNumStates( void ) const noexcept {
+    return mNumStates;
+}
+
+//==============================================================================================================================
+template< typename agentState_t >
+inline batchCondition_c< agentState_t >::batchCondition_c( std::string_view cName, const kernel_t& cKernel ) :
+    mcName( cName ),
+    mcKernel( cKernel ),
+    mNumStates( 0 ) {}
+
+} // namespace smd::fbt
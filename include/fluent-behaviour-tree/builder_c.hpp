@@ -29,146 +29,213 @@
 #include "node_i.hpp"
 #include "parentnode_i.hpp"
 #include "actionnode_c.hpp"
+#include "conditionnode_c.hpp"
+#include "batchcondition_c.hpp"
 #include "inverternode_c.hpp"
+#include "lazysubtreenode_c.hpp"
 #include "parallelnode_c.hpp"
+#include "reactiveselectornode_c.hpp"
 #include "selectornode_c.hpp"
 #include "sequencenode_c.hpp"
+#include "subtreenode_c.hpp"
+#include "waitnode_c.hpp"
+#include "tree_c.hpp"
+#include "library_c.hpp"
 
 namespace smd::fbt {
 
 //==============================================================================================================================
-// Fluent API for building a behaviour tree.
+// Fluent API for building a behaviour tree. Names are copied once into their nodes and functions are forwarded into their
+// final storage, the builder reuses its own memory when it builds many trees.
 //==============================================================================================================================
 template< typename timeData_t >
 class builder_c final {
-    using nodePtr_t       = std::shared_ptr< node_i< timeData_t > >;
-    using parentNodePtr_t = std::shared_ptr< parentNode_i< timeData_t > >;
-    using function_t      = std::function< status_t( timeData_t ) >;
-    using funcBool_t      = std::function< bool( timeData_t ) >;
+    using tree_t       = tree_c< timeData_t >;
+    using treePtr_t    = std::unique_ptr< tree_t >;
+    using subTreePtr_t = std::shared_ptr< const tree_t >;
+    using library_t    = library_c< timeData_t >;
+    using node_t       = node_i< timeData_t >;
+    using parentNode_t = parentNode_i< timeData_t >;
+    using stack_t      = std::stack< parentNode_t*, std::vector< parentNode_t* > >;
 
 public:
-    inline builder_c& mDo( const std::string& cName, const function_t& cFunction );
-    inline builder_c& mCondition( const std::string& cName, const funcBool_t& cFunction );
-    inline builder_c& mInverter( const std::string& cName );
-    inline builder_c& mSequence( const std::string& cName );
-    inline builder_c& mParallel( const std::string& cName, uint32_t numToFail, uint32_t numToSucceed );
-    inline builder_c& mSelector( const std::string& cName );
-
-    inline builder_c& mSplice( nodePtr_t pSubTree );
+    template< typename function_tt >
+    inline builder_c& mDo( std::string_view cName, function_tt&& function );
+    template< typename function_tt >
+    inline builder_c& mCondition( std::string_view cName, function_tt&& function );
+    template< typename function_tt >
+    inline builder_c& mSharedCondition( std::string_view cName, function_tt&& function );
+    template< typename agentState_t >
+    inline builder_c& mBatchCondition( std::string_view cName,
+                                       std::shared_ptr< const batchCondition_c< agentState_t > > pCondition );
+    inline builder_c& mWait( std::string_view cName, uint32_t event );
+    inline builder_c& mInverter( std::string_view cName );
+    inline builder_c& mSequence( std::string_view cName );
+    inline builder_c& mParallel( std::string_view cName, uint32_t numToFail, uint32_t numToSucceed );
+    inline builder_c& mSelector( std::string_view cName );
+    inline builder_c& mReactiveSelector( std::string_view cName );
+
+    inline builder_c& mSplice( subTreePtr_t pSubTree );
+    inline builder_c& mSplice( const library_t& cLibrary, std::string_view cName );
+    inline builder_c& mSpliceLazy( std::string_view cName, std::function< subTreePtr_t( void ) > factory,
+                                   uint32_t stateCapacity );
     inline builder_c& mEnd( void );
-    inline nodePtr_t  mBuild( void );
+    inline treePtr_t  mBuild( void );
 
-    builder_c& operator=( const builder_c& ) = delete;
-    builder_c& operator=( builder_c&& )      noexcept = delete;
-               builder_c( void )             = default;
-               builder_c( const builder_c& ) = delete;
-               builder_c( builder_c&& )      noexcept = delete;
-               ~builder_c( void )            = default;
+    builder_c&      operator=( const builder_c& ) = delete;
+    builder_c&      operator=( builder_c&& )      noexcept = default;
+    inline          builder_c( void );
+                    builder_c( const builder_c& ) = delete;
+                    builder_c( builder_c&& )      noexcept = default;
+                    ~builder_c( void )            = default;
 
 private:
-    nodePtr_t                     mpCurrent; // Last node created.
-    std::stack< parentNodePtr_t > mStack;    // Stack node nodes that we are build via the fluent API.
+    treePtr_t mpTree;    // Tree that owns the nodes being built.
+    node_t*   mpCurrent; // Last node created.
+    stack_t   mStack;    // Stack node nodes that we are build via the fluent API.
+
+    inline tree_t& mGetTree( void );
+
+    template< typename node_tt, typename... args_tt >
+    inline builder_c& mPushParent( args_tt&&... args );
+    template< typename node_tt, typename function_tt, typename... args_tt >
+    inline builder_c& mAddLeaf( std::string_view cName, function_tt&& function, args_tt&&... args );
 };
 
 //==============================================================================================================================
 // Create an action node.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mDo( const std::string& cName, const function_t& cFunction ) ->builder_c& {
-    if ( mStack.empty() ) {
-        throw except_c( "Can't create an unnested 'actionNode_c', it must be a leaf node." );
-    }
-
-    mStack.top()->mAddChild( std::make_shared< actionNode_c< timeData_t > >( cName, cFunction ) );
-
-    return *this;
+template< typename function_tt >
+inline auto builder_c< timeData_t >::mDo( std::string_view cName, function_tt&& function ) ->builder_c& {
+    return mAddLeaf< actionNode_c< timeData_t > >( cName, std::forward< function_tt >( function ) );
 }
 
 //==============================================================================================================================
 // Like an action node... but the function can return true/false and is mapped to success/failure.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mCondition( const std::string& cName, const funcBool_t& cFunction ) ->builder_c& {
-    return mDo( cName, [ cFunction ]( timeData_t timeDelta ) ->status_t {
-        return cFunction( timeDelta ) ? status_t::SUCCESS : status_t::FAILURE;
-    } );
+template< typename function_tt >
+inline auto builder_c< timeData_t >::mCondition( std::string_view cName, function_tt&& function ) ->builder_c& {
+    return mAddLeaf< conditionNode_c< timeData_t > >( cName, std::forward< function_tt >( function ) );
 }
 
 //==============================================================================================================================
-// Create an inverter node that inverts the success/failure of its children.
+// Like a condition node... but in a tree that shares guards it's evaluated once per tick with the shared conditions of the
+// same name (see 'tree_c::mSetGuardSharing'). Use it only when the name tells what the function tests.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mInverter( const std::string& cName ) ->builder_c& {
-    auto pNode = std::make_shared< inverterNode_c< timeData_t > >( cName );
+template< typename function_tt >
+inline auto builder_c< timeData_t >::mSharedCondition( std::string_view cName, function_tt&& function ) ->builder_c& {
+    return mAddLeaf< conditionNode_c< timeData_t > >( cName, std::forward< function_tt >( function ), true );
+}
 
-    if ( mStack.size() ) {
-        mStack.top()->mAddChild( pNode );
+//==============================================================================================================================
+// Like a condition node... but reads the result of the ticked agent from a batch condition evaluated beforehand. 'pAgent' of
+// the instance must point at the state of the agent in the evaluated batch.
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename agentState_t >
+inline auto builder_c< timeData_t >::mBatchCondition( std::string_view cName,
+                                                     std::shared_ptr< const batchCondition_c< agentState_t > > pCondition )
+                                                     ->builder_c& {
+    if ( !pCondition ) {
+        SMD_FBT_THROW( "Can't create a batch condition without 'batchCondition_c'." );
     }
 
-    mStack.emplace( pNode );
-
-    return *this;
+    return mCondition( cName, [ pCondition = move( pCondition ) ]( const tickContext_t< timeData_t >& cContext ) {
+        return pCondition->mcTest( pCondition->mcFind( cContext.pAgent ) );
+    } );
 }
 
 //==============================================================================================================================
-// Create a sequence node.
+// Create a wait node that runs until 'event' wakes its instance up.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mSequence( const std::string& cName ) ->builder_c& {
-    auto pNode = std::make_shared< sequenceNode_c< timeData_t > >( cName );
-
-    if ( mStack.size() ) {
-        mStack.top()->mAddChild( pNode );
+inline auto builder_c< timeData_t >::mWait( std::string_view cName, uint32_t event ) ->builder_c& {
+    if ( mStack.empty() ) {
+        SMD_FBT_THROW( "Can't create an unnested leaf node, it must have a parent node." );
     }
 
-    mStack.emplace( pNode );
+    mStack.top()->mAddChild( mGetTree().template mCreate< waitNode_c< timeData_t > >( cName, event ) );
 
     return *this;
 }
 
 //==============================================================================================================================
-// Create a parallel node.
+// Create an inverter node that inverts the success/failure of its children.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mParallel( const std::string& cName,
-                                               uint32_t numToFail, uint32_t numToSucceed ) ->builder_c& {
-    auto pNode = std::make_shared< parallelNode_c< timeData_t > >( cName, numToFail, numToSucceed );
-
-    if ( mStack.size() ) {
-        mStack.top()->mAddChild( pNode );
-    }
+inline auto builder_c< timeData_t >::mInverter( std::string_view cName ) ->builder_c& {
+    return mPushParent< inverterNode_c< timeData_t > >( cName );
+}
 
-    mStack.emplace( pNode );
+//==============================================================================================================================
+// Create a sequence node.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto builder_c< timeData_t >::mSequence( std::string_view cName ) ->builder_c& {
+    return mPushParent< sequenceNode_c< timeData_t > >( cName );
+}
 
-    return *this;
+//==============================================================================================================================
+// Create a parallel node.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto builder_c< timeData_t >::mParallel( std::string_view cName, uint32_t numToFail, uint32_t numToSucceed ) ->builder_c& {
+    return mPushParent< parallelNode_c< timeData_t > >( cName, numToFail, numToSucceed );
 }
 
 //==============================================================================================================================
 // Create a selector node.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mSelector( const std::string& cName ) ->builder_c& {
-    auto pNode = std::make_shared< selectorNode_c< timeData_t > >( cName );
+inline auto builder_c< timeData_t >::mSelector( std::string_view cName ) ->builder_c& {
+    return mPushParent< selectorNode_c< timeData_t > >( cName );
+}
 
-    if ( mStack.size() ) {
-        mStack.top()->mAddChild( pNode );
+//==============================================================================================================================
+// Create a reactive selector node, its guarded branches should start with a condition.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto builder_c< timeData_t >::mReactiveSelector( std::string_view cName ) ->builder_c& {
+    return mPushParent< reactiveSelectorNode_c< timeData_t > >( cName );
+}
+
+//==============================================================================================================================
+// Splice a sub tree into the parent tree. The sub-tree isn't copied, it's shared by all trees that splice it.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto builder_c< timeData_t >::mSplice( subTreePtr_t pSubTree ) ->builder_c& {
+    if ( mStack.empty() ) {
+        SMD_FBT_THROW( "Can't splice an unnested sub-tree, there must be a parent-tree." );
     }
 
-    mStack.emplace( pNode );
+    mStack.top()->mAddChild( mGetTree().template mCreate< subtreeNode_c< timeData_t > >( move( pSubTree ) ) );
 
     return *this;
 }
 
 //==============================================================================================================================
-// Splice a sub tree into the parent tree.
+// Splice a behaviour defined in the library.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto builder_c< timeData_t >::mSplice( const library_t& cLibrary, std::string_view cName ) ->builder_c& {
+    return mSplice( cLibrary.mcGet( cName ) );
+}
+
+//==============================================================================================================================
+// Splice a sub-tree that 'factory' builds when it's ticked for the first time, its state must fit in 'stateCapacity' bytes.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mSplice( nodePtr_t pSubTree ) ->builder_c& {
+inline auto builder_c< timeData_t >::mSpliceLazy( std::string_view cName, std::function< subTreePtr_t( void ) > factory,
+                                                  uint32_t stateCapacity ) ->builder_c& {
     if ( mStack.empty() ) {
-        throw except_c( "Can't splice an unnested sub-tree, there must be a parent-tree." );
+        SMD_FBT_THROW( "Can't splice an unnested sub-tree, there must be a parent-tree." );
     }
 
-    mStack.top()->mAddChild( move( pSubTree ) );
+    mStack.top()->mAddChild(
+        mGetTree().template mCreate< lazySubtreeNode_c< timeData_t > >( cName, move( factory ), stateCapacity ) );
 
     return *this;
 }
@@ -178,6 +245,13 @@ inline auto builder_c< timeData_t >::mSplice( nodePtr_t pSubTree ) ->builder_c&
 //==============================================================================================================================
 template< typename timeData_t >
 inline auto builder_c< timeData_t >::mEnd( void ) ->builder_c& {
+    if ( mStack.empty() ) {
+        SMD_FBT_THROW( "Can't end a node, there are more 'mEnd()' than parent nodes." );
+    }
+    if ( !mStack.top()->mcIsComplete() ) {
+        SMD_FBT_THROW( "Can't end a node that misses its children, e.g. 'inverterNode_c' without a child." );
+    }
+
     mpCurrent = mStack.top();
     mStack.pop();
 
@@ -185,15 +259,82 @@ inline auto builder_c< timeData_t >::mEnd( void ) ->builder_c& {
 }
 
 //==============================================================================================================================
-// Build the actual tree.
+// Build the actual tree. All structural checks are done here or earlier, so ticking the tree never fails.
 //==============================================================================================================================
 template< typename timeData_t >
-inline auto builder_c< timeData_t >::mBuild( void ) ->nodePtr_t {
+inline auto builder_c< timeData_t >::mBuild( void ) ->treePtr_t {
+    if ( !mStack.empty() ) {
+        SMD_FBT_THROW( "Can't create an unbalanced behaviour tree, there are less 'mEnd()' than parent nodes." );
+    }
     if ( !mpCurrent ) {
-        throw except_c( "Can't create a behaviour tree with zero nodes" );
+        SMD_FBT_THROW( "Can't create a behaviour tree with zero nodes" );
+    }
+
+    mpTree->mSetRoot( mpCurrent );
+    mpCurrent = nullptr;
+
+    return move( mpTree );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline builder_c< timeData_t >::builder_c( void ) :
+    mpCurrent( nullptr ) {}
+
+//==============================================================================================================================
+// The tree is created lazily, so the builder is ready for the next tree right after 'mBuild()'.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto builder_c< timeData_t >::mGetTree( void ) ->tree_t& {
+    if ( !mpTree ) {
+        mpTree = std::make_unique< tree_t >();
     }
 
-    return mpCurrent;
+    return *mpTree;
+}
+
+//==============================================================================================================================
+// Creates a parent node and makes it current, so next nodes become its children until 'mEnd()'.
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename node_tt, typename... args_tt >
+inline auto builder_c< timeData_t >::mPushParent( args_tt&&... args ) ->builder_c& {
+    node_tt* const cpNode { mGetTree().template mCreate< node_tt >( std::forward< args_tt >( args )... ) };
+
+    if ( mStack.size() ) {
+        mStack.top()->mAddChild( cpNode );
+    }
+
+    mStack.emplace( cpNode );
+
+    return *this;
+}
+
+//==============================================================================================================================
+// Creates a leaf node, the function is moved into the node when it's passed as an rvalue. A function taking the tick context
+// instead of the time data gets the context, e.g. to reach its agent through 'pAgent'.
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename node_tt, typename function_tt, typename... args_tt >
+inline auto builder_c< timeData_t >::mAddLeaf( std::string_view cName, function_tt&& function, args_tt&&... args ) ->builder_c& {
+    if ( mStack.empty() ) {
+        SMD_FBT_THROW( "Can't create an unnested leaf node, it must have a parent node." );
+    }
+
+    using function_t = std::conditional_t< std::is_invocable_v< function_tt, const typename node_t::context_t& >,
+                                           typename node_tt::contextFunction_t,
+                                           typename node_tt::function_t >;
+
+    function_t leafFunction( std::forward< function_tt >( function ) );
+
+    if ( !leafFunction ) {
+        SMD_FBT_THROW( "Can't create a leaf node with an empty function." );
+    }
+
+    mStack.top()->mAddChild( mGetTree().template mCreate< node_tt >( cName, move( leafFunction ),
+                                                                                  std::forward< args_tt >( args )... ) );
+
+    return *this;
 }
 
 } // namespace smd::fbt
@@ -0,0 +1,313 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "parentnode_i.hpp"
+#include "parallelnode_c.hpp"
+
+#include <sstream>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Generates a C++ header that implements a built tree as straight-line code. The generated function
+//
+//     template< typename timeData_t, typename leaves_t >
+//     smd::fbt::status_t <function>( leaves_t& leaves, smd::fbt::param_t< timeData_t > timeData ) noexcept;
+//
+// calls 'leaves( std::integral_constant< size_t, i >(), timeData )' for the leaf 'i' of 'mcGetLeaves()': an action must return
+// 'status_t', a condition must return 'bool'. The names of the leaves are emitted as '<function>Leaves[]' for the fix-up.
+// 'timeData_t' can't be deduced from 'param_t', so it's given explicitly: '<function>< float >( leaves, 0.5f )'.
+//==============================================================================================================================
+template< typename timeData_t >
+class codegen_c final {
+    using node_t = node_i< timeData_t >;
+
+public:
+    inline std::string mEmit( const node_t& cRoot, const std::string& cFunction,
+                              const std::string& cInclude = "fluent-behaviour-tree.hpp" );
+
+    inline const std::vector< const node_t* >& mcGetLeaves( void ) const noexcept;
+
+    codegen_c& operator=( const codegen_c& ) = delete;
+    codegen_c& operator=( codegen_c&& )      noexcept = delete;
+               codegen_c( void )             = default;
+               codegen_c( const codegen_c& ) = delete;
+               codegen_c( codegen_c&& )      noexcept = delete;
+               ~codegen_c( void )            = default;
+
+private:
+    std::vector< const node_t* > mLeaves;             // Leaves in the order of their indices in the generated code.
+    std::stringstream            mOut;                // Generated code.
+    uint32_t                     mNumParallels { 0 }; // Used to make unique names of the parallel counters.
+
+    inline void mEmitNode( const node_t& cNode, uint32_t depth );
+    inline void mEmitIndent( uint32_t depth );
+
+    static inline std::string mcEscape( const std::string& cName );
+    static inline bool        mcIsIdentifier( const std::string& cName );
+};
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline std::string codegen_c< timeData_t >::mEmit( const node_t& cRoot, const std::string& cFunction,
+                                                   const std::string& cInclude ) {
+    if ( !mcIsIdentifier( cFunction ) ) {
+        SMD_FBT_THROW( "Can't generate code for a function whose name isn't a C++ identifier." );
+    }
+
+    mLeaves.clear();
+    mOut.str( "" );
+    mNumParallels = 0;
+
+    mOut << "// Generated by 'smd::fbt::codegen_c' from the tree \"" << mcEscape( cRoot.mcName ) << "\", don't edit.\n"
+         << "\n"
+         << "#pragma once\n"
+         << "\n"
+         << "#include \"" << cInclude << "\"\n"
+         << "\n"
+         << "#include <cstdint>\n"
+         << "#include <type_traits>\n"
+         << "\n"
+         << "template< typename timeData_t, typename leaves_t >\n"
+         << "inline smd::fbt::status_t " << cFunction << "( leaves_t& leaves, smd::fbt::param_t< timeData_t > timeData ) noexcept {\n"
+         << "    using smd::fbt::status_t;\n"
+         << "\n"
+         << "    status_t status;\n"
+         << "\n";
+
+    mEmitNode( cRoot, 1 );
+
+    mOut << "\n"
+         << "    return status;\n"
+         << "}\n"
+         << "\n"
+         << "constexpr const char* " << cFunction << "Leaves[] {\n";
+
+    for ( const node_t* pLeaf : mLeaves ) {
+        mOut << "    \"" << mcEscape( pLeaf->mcName ) << "\",\n";
+    }
+
+    mOut << "};\n";
+
+    return mOut.str();
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto codegen_c< timeData_t >::mcGetLeaves( void ) const noexcept ->const std::vector< const node_t* >& {
+    return mLeaves;
+}
+
+//==============================================================================================================================
+// Every node writes its result into 'status', parents read results of their children from there as well.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void codegen_c< timeData_t >::mEmitNode( const node_t& cNode, uint32_t depth ) {
+    if ( cNode.mcKind == nodeKind_t::WAIT ) {
+        SMD_FBT_THROW( "Can't generate code for a wait node, it waits for events from a scheduler." );
+    }
+    if ( cNode.mcKind == nodeKind_t::LAZY_SUBTREE ) {
+        SMD_FBT_THROW( "Can't generate code for a lazy sub-tree, it's built at runtime." );
+    }
+
+    if ( !cNode.mcIsParent() ) {
+        mEmitIndent( depth );
+        mOut << "status = ";
+
+        if ( cNode.mcKind == nodeKind_t::CONDITION ) {
+            mOut << "leaves( std::integral_constant< size_t, " << mLeaves.size() << " >(), timeData ) ? "
+                 << "status_t::SUCCESS : status_t::FAILURE;";
+        } else {
+            mOut << "leaves( std::integral_constant< size_t, " << mLeaves.size() << " >(), timeData );";
+        }
+
+        mOut << " // \"" << mcEscape( cNode.mcName ) << "\"\n";
+        mLeaves.emplace_back( &cNode );
+        return;
+    }
+
+    const auto& cChildren = cNode.mcGetChildren();
+
+    switch ( cNode.mcKind ) {
+        case nodeKind_t::INVERTER: {
+            mEmitNode( *cChildren.front(), depth );
+            mEmitIndent( depth );
+            mOut << "status = smd::fbt::invertStatus( status ); // \"" << mcEscape( cNode.mcName ) << "\"\n";
+            break;
+        }
+        case nodeKind_t::SUBTREE: {
+            mEmitNode( *cChildren.front(), depth );
+            break;
+        }
+        case nodeKind_t::SEQUENCE:
+        case nodeKind_t::SELECTOR: {
+            const char* cpContinue { cNode.mcKind == nodeKind_t::SEQUENCE ? "SUCCESS" : "FAILURE" };
+
+            mEmitIndent( depth );
+            mOut << "do { // \"" << mcEscape( cNode.mcName ) << "\"\n";
+
+            for ( size_t iChild { 0 }; iChild < cChildren.size(); ++iChild ) {
+                mEmitNode( *cChildren[ iChild ], depth + 1 );
+
+                if ( iChild + 1 < cChildren.size() ) {
+                    mEmitIndent( depth + 1 );
+                    mOut << "if ( status != status_t::" << cpContinue << " ) break;\n";
+                }
+            }
+
+            mEmitIndent( depth );
+            mOut << "} while ( false );\n";
+            break;
+        }
+        case nodeKind_t::PARALLEL: {
+            const auto&    cParallel { static_cast< const parallelNode_c< timeData_t >& >( cNode ) };
+            const uint32_t cIndex    { mNumParallels++ };
+
+            const uint32_t cNumToSucceed { cParallel.mcGetNumToSucceed() };
+            const uint32_t cNumToFail    { cParallel.mcGetNumToFail() };
+
+            mEmitIndent( depth );
+            mOut << "{ // \"" << mcEscape( cNode.mcName ) << "\"\n";
+
+            if ( cNumToSucceed > 0 ) {
+                mEmitIndent( depth + 1 );
+                mOut << "uint32_t numSucceeded" << cIndex << " { 0 };\n";
+            }
+            if ( cNumToFail > 0 ) {
+                mEmitIndent( depth + 1 );
+                mOut << "uint32_t numFailed" << cIndex << " { 0 };\n";
+            }
+
+            for ( const auto& cpChild : cChildren ) {
+                mEmitNode( *cpChild, depth + 1 );
+
+                if ( cNumToSucceed > 0 ) {
+                    mEmitIndent( depth + 1 );
+                    mOut << "numSucceeded" << cIndex << " += status == status_t::SUCCESS;\n";
+                }
+                if ( cNumToFail > 0 ) {
+                    mEmitIndent( depth + 1 );
+                    mOut << "numFailed" << cIndex << " += status == status_t::FAILURE;\n";
+                }
+            }
+
+            mEmitIndent( depth + 1 );
+            mOut << "status = ";
+
+            if ( cNumToSucceed > 0 ) {
+                mOut << "numSucceeded" << cIndex << " >= " << cNumToSucceed << " ? status_t::SUCCESS : ";
+            }
+            if ( cNumToFail > 0 ) {
+                mOut << "numFailed" << cIndex << " >= " << cNumToFail << " ? status_t::FAILURE : ";
+            }
+
+            mOut << "status_t::RUNNING;\n";
+            mEmitIndent( depth );
+            mOut << "}\n";
+            break;
+        }
+        case nodeKind_t::REACTIVE_SELECTOR:
+            SMD_FBT_THROW( "Can't generate code for a reactive selector, it resumes the running branch from its state." );
+        default:
+            SMD_FBT_THROW( "Can't generate code for an unknown kind of node." );
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void codegen_c< timeData_t >::mEmitIndent( uint32_t depth ) {
+    for ( uint32_t iLevel { 0 }; iLevel < depth; ++iLevel ) {
+        mOut << "    ";
+    }
+}
+
+//==============================================================================================================================
+// Control characters are escaped as three octal digits, so a digit following one can't be taken into the escape sequence.
+//==============================================================================================================================
+template< typename timeData_t >
+inline std::string codegen_c< timeData_t >::mcEscape( const std::string& cName ) {
+    std::string escaped;
+
+    for ( const char cChar : cName ) {
+        const auto cCode = static_cast< unsigned char >( cChar );
+
+        if ( cChar == '"' || cChar == '\\' ) {
+            escaped += '\\';
+        }
+        if ( cChar == '\n' ) {
+            escaped += "\\n";
+            continue;
+        }
+        if ( cCode < 0x20 || cCode == 0x7F ) {
+            escaped += '\\';
+            escaped += static_cast< char >( '0' + ( cCode >> 6 ) );
+            escaped += static_cast< char >( '0' + ( ( cCode >> 3 ) & 7 ) );
+            escaped += static_cast< char >( '0' + ( cCode & 7 ) );
+            continue;
+        }
+
+        escaped += cChar;
+    }
+
+    return escaped;
+}
+
+//==============================================================================================================================
+// Letters, digits and underscores not starting with a digit, and not a keyword.
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool codegen_c< timeData_t >::mcIsIdentifier( const std::string& cName ) {
+    static const std::unordered_set< std::string_view > cKeywords {
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char",
+        "char16_t", "char32_t", "class", "compl", "const", "const_cast", "constexpr", "continue", "decltype", "default",
+        "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+        "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr",
+        "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "return", "short",
+        "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local",
+        "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile",
+        "wchar_t", "while", "xor", "xor_eq"
+    };
+
+    auto isLetter = []( char c ) { return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || c == '_'; };
+    auto isDigit  = []( char c ) { return c >= '0' && c <= '9'; };
+
+    if ( cName.empty() || !isLetter( cName.front() ) ) {
+        return false;
+    }
+
+    for ( const char cChar : cName ) {
+        if ( !isLetter( cChar ) && !isDigit( cChar ) ) {
+            return false;
+        }
+    }
+
+    return cKeywords.count( cName ) == 0;
+}
+
+} // namespace smd::fbt
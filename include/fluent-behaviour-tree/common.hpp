@@ -25,15 +25,43 @@
 
 #pragma once
 
+#ifndef SMD_FBT_NO_EXCEPTIONS
 #include "except_c.hpp"
+#endif
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
+#include <map>
 #include <memory>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+//==============================================================================================================================
+// Structural errors are reported while a tree is being built, ticking never throws. Define 'SMD_FBT_NO_EXCEPTIONS' to compile
+// with '-fno-exceptions', then a build error prints the message and aborts.
+//==============================================================================================================================
+#ifdef SMD_FBT_NO_EXCEPTIONS
+#define SMD_FBT_THROW( what )                    \
+    do {                                         \
+        std::fprintf( stderr, "%s\n", what );    \
+        std::abort();                            \
+    } while ( 0 )
+#else
+#define SMD_FBT_THROW( what ) throw smd::except_c( what )
+#endif
+
 namespace smd::fbt {
 
 //==============================================================================================================================
@@ -43,4 +71,45 @@ enum class status_t : uint32_t {
     RUNNING
 };
 
+//==============================================================================================================================
+enum class nodeKind_t : uint32_t {
+    ACTION,
+    CONDITION,
+    INVERTER,
+    LAZY_SUBTREE,
+    PARALLEL,
+    REACTIVE_SELECTOR,
+    SELECTOR,
+    SEQUENCE,
+    SUBTREE,
+    WAIT
+};
+
+//==============================================================================================================================
+// How 'timeData_t' is passed through a tick: by value when it's as cheap as a pointer to copy, by const reference otherwise so
+// a large frame context isn't copied at every node and leaf.
+//==============================================================================================================================
+template< typename type_t >
+using param_t = std::conditional_t< std::is_trivially_copyable_v< type_t > && sizeof( type_t ) <= 2 * sizeof( void* ),
+                                    type_t,
+                                    const type_t& >;
+
+//==============================================================================================================================
+// Whether two functions wrap callables of the same type, and the same function when it's a plain pointer. Closures of one
+// lambda count as the same function whatever they capture, captures can't be compared.
+//==============================================================================================================================
+template< typename result_t, typename... args_t >
+inline bool isSameFunction( const std::function< result_t( args_t... ) >& cA,
+                            const std::function< result_t( args_t... ) >& cB ) noexcept {
+    using pointer_t = result_t ( * )( args_t... );
+
+    if ( cA.target_type() != cB.target_type() ) {
+        return false;
+    }
+
+    const pointer_t* const cpA { cA.template target< pointer_t >() };
+
+    return !cpA || *cpA == *cB.template target< pointer_t >();
+}
+
 } // namespace smd::fbt
@@ -0,0 +1,154 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// A behaviour tree leaf node for checking a condition, true/false is mapped to success/failure. In a tree that shares guards
+// (see 'tree_c::mSetGuardSharing') shared conditions of the same name share a slot of the state, the first one ticked in a
+// tick evaluates the function and stamps the result with the epoch of the tick, the others just read it. A condition is only
+// shared when it's created so, e.g. by 'builder_c::mSharedCondition', as its name must then identify what it tests.
+//==============================================================================================================================
+template< typename timeData_t >
+class conditionNode_c final : public node_i< timeData_t > {
+    using node_t    = node_i< timeData_t >;
+    using context_t = typename node_t::context_t;
+
+public:
+    using function_t        = std::function< bool( param_t< timeData_t > ) >;
+    using contextFunction_t = std::function< bool( const context_t& ) >; // For leaves needing the agent or the state.
+
+    struct guard_t final {
+        uint64_t epoch;  // Of the tick the result is for.
+        uint64_t isTrue;
+    };
+
+    static constexpr uint32_t cNoGuard { UINT32_MAX };
+
+    const bool mcIsShared; // Whether it shares its result with the shared conditions of the same name.
+
+    inline status_t mTick( context_t& context ) const noexcept override;
+    inline void     mSetGuardOffset( uint32_t guardOffset )       noexcept; // Set by the tree, relative to its state.
+
+    inline uint32_t mcGetGuardOffset( void ) const noexcept; // Or 'cNoGuard' if the condition isn't shared.
+
+    inline bool mcHasSameFunction( const conditionNode_c& cOther ) const noexcept; // See 'isSameFunction'.
+
+    conditionNode_c& operator=( const conditionNode_c& ) = delete;
+    conditionNode_c& operator=( conditionNode_c&& )      noexcept = delete;
+    inline           conditionNode_c( std::string_view cName, function_t function, bool isShared = false );
+    inline           conditionNode_c( std::string_view cName, contextFunction_t function, bool isShared = false );
+    inline           conditionNode_c( const conditionNode_c& cNode );
+    inline           conditionNode_c( conditionNode_c&& node );
+                     ~conditionNode_c( void ) = default;
+
+private:
+    function_t        mFunction;                 // Function to invoke for the condition.
+    contextFunction_t mContextFunction;          // Or this one if it takes the context.
+    uint32_t          mGuardOffset { cNoGuard }; // Slot of the shared result.
+
+    inline bool mcEvaluate( const context_t& cContext ) const noexcept;
+};
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t conditionNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    if ( mGuardOffset == cNoGuard || context.epoch == 0 ) {
+        return mcEvaluate( context ) ? status_t::SUCCESS : status_t::FAILURE;
+    }
+
+    guard_t guard;
+    std::memcpy( &guard, context.pState + mGuardOffset, sizeof( guard_t ) );
+
+    if ( guard.epoch != context.epoch ) {
+        guard = guard_t { context.epoch, mcEvaluate( context ) };
+        std::memcpy( context.pState + mGuardOffset, &guard, sizeof( guard_t ) );
+    }
+
+    return guard.isTrue ? status_t::SUCCESS : status_t::FAILURE;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void conditionNode_c< timeData_t >::mSetGuardOffset( uint32_t guardOffset ) noexcept {
+    mGuardOffset = guardOffset;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t conditionNode_c< timeData_t >::mcGetGuardOffset( void ) const noexcept {
+    return mGuardOffset;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool conditionNode_c< timeData_t >::mcHasSameFunction( const conditionNode_c& cOther ) const noexcept {
+    return isSameFunction( mFunction, cOther.mFunction ) && isSameFunction( mContextFunction, cOther.mContextFunction );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool conditionNode_c< timeData_t >::mcEvaluate( const context_t& cContext ) const noexcept {
+    return mContextFunction ? mContextFunction( cContext ) : mFunction( cContext.timeData );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline conditionNode_c< timeData_t >::conditionNode_c( std::string_view cName, function_t function, bool isShared ) :
+    node_t( nodeKind_t::CONDITION, cName ),
+    mcIsShared( isShared ),
+    mFunction( move( function ) ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline conditionNode_c< timeData_t >::conditionNode_c( std::string_view cName, contextFunction_t function, bool isShared ) :
+    node_t( nodeKind_t::CONDITION, cName ),
+    mcIsShared( isShared ),
+    mContextFunction( move( function ) ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline conditionNode_c< timeData_t >::conditionNode_c( const conditionNode_c& cNode ) :
+    node_t( cNode ),
+    mcIsShared( cNode.mcIsShared ),
+    mFunction( cNode.mFunction ),
+    mContextFunction( cNode.mContextFunction ),
+    mGuardOffset( cNode.mGuardOffset ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline conditionNode_c< timeData_t >::conditionNode_c( conditionNode_c&& node ) :
+    node_t( std::move( node ) ),
+    mcIsShared( node.mcIsShared ),
+    mFunction( std::move( node.mFunction ) ),
+    mContextFunction( std::move( node.mContextFunction ) ),
+    mGuardOffset( node.mGuardOffset ) {}
+
+} // namespace smd::fbt
@@ -0,0 +1,668 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "parentnode_i.hpp"
+#include "actionnode_c.hpp"
+#include "conditionnode_c.hpp"
+#include "inverternode_c.hpp"
+#include "lazysubtreenode_c.hpp"
+#include "parallelnode_c.hpp"
+#include "reactiveselectornode_c.hpp"
+#include "selectornode_c.hpp"
+#include "sequencenode_c.hpp"
+#include "subtreenode_c.hpp"
+#include "waitnode_c.hpp"
+#include "tree_c.hpp"
+
+#include <fstream>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// A built tree flattened into a relocatable image, so a process can load its trees instead of building them again. The image
+// is a header, the records of all nodes in pre-order, the child lists and a string table of the names, all addressed by
+// offsets. The trees spliced by a tree are stored in the same image, once each however often they are spliced.
+//
+// Functions can't be stored, the leaves are fixed up by name when the image is loaded: bind a function to the name of every
+// action and condition with 'mDo' and 'mCondition', and a factory to every lazy sub-tree with 'mSpliceLazy'. Leaves that share
+// a name share the function. 'mcLoad' maps the file and creates the nodes straight from the records.
+//
+// A loaded tree lays out its state from scratch, so only compact trees (see 'tree_c::mcIsCompact') are flattened: an edited
+// tree is flattened after 'mCompact'. Then the loaded tree lays out its state exactly as the saved one and snapshots stay
+// compatible, the image keeps the size of the state to check that.
+//==============================================================================================================================
+template< typename timeData_t >
+class image_c final {
+    using tree_t    = tree_c< timeData_t >;
+    using treePtr_t = std::unique_ptr< tree_t >;
+    using node_t    = node_i< timeData_t >;
+    using context_t = typename node_t::context_t;
+
+public:
+    static constexpr uint32_t cMagic    { 0x49544246 }; // "FBTI".
+    static constexpr uint32_t cVersion  { 4 };
+    static constexpr uint32_t cMaxDepth { 1024 };       // Nodes on a path from a root to a leaf.
+
+    using factory_t = typename lazySubtreeNode_c< timeData_t >::factory_t;
+
+    template< typename function_tt >
+    inline image_c& mDo( std::string_view cName, function_tt&& function );
+    template< typename function_tt >
+    inline image_c& mCondition( std::string_view cName, function_tt&& function );
+    inline image_c& mSpliceLazy( std::string_view cName, factory_t factory );
+
+    inline treePtr_t mcLoad( const std::string& cPath )                      const;
+    inline treePtr_t mcInstantiate( const uint8_t* cpImage, size_t numBytes ) const; // From an image in memory.
+
+    static inline std::vector< uint8_t > mFlatten( const tree_t& cTree );
+    static inline void                   mSave( const tree_t& cTree, const std::string& cPath );
+
+    image_c&  operator=( const image_c& ) = default;
+    image_c&  operator=( image_c&& )      noexcept = default;
+              image_c( void )             = default;
+              image_c( const image_c& )   = default;
+              image_c( image_c&& )        noexcept = default;
+              ~image_c( void )            = default;
+
+private:
+    struct header_t final {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numTrees;
+        uint32_t numNodes;
+        uint32_t numChildren;
+        uint32_t numStringBytes;
+    };
+
+    struct treeRecord_t final {
+        uint32_t iRoot;     // Record of the root node.
+        uint32_t flags;     // 'cHasMemory' and 'cSharesGuards'.
+        uint32_t stateSize; // Of the saved tree, the loaded one must lay out the same.
+    };
+
+    static constexpr uint32_t cHasMemory    { 1 };
+    static constexpr uint32_t cSharesGuards { 2 };
+
+    struct nodeRecord_t final {
+        uint32_t kind;
+        uint32_t nameOffset;  // In the string table.
+        uint32_t nameSize;
+        uint32_t firstChild;  // In the child lists.
+        uint32_t numChildren;
+        uint32_t arg0;        // Failures of a parallel, event of a wait node, spliced tree, state capacity of a lazy one or
+                              // whether a condition is shared.
+        uint32_t arg1;        // Successes of a parallel.
+    };
+
+    struct binding_t final {
+        nodeKind_t                                                       kind;
+        std::function< node_t*( tree_t&, std::string_view, uint32_t ) > create; // Creates the node, given the 'arg0'.
+    };
+
+    struct writer_t final {
+        std::vector< const tree_t* >                  trees;       // Trees to flatten, spliced ones are appended.
+        std::unordered_map< const tree_t*, uint32_t > treeIndices;
+        std::vector< treeRecord_t >                   treeRecords;
+        std::vector< nodeRecord_t >                   nodes;
+        std::vector< uint32_t >                       children;
+        std::string                                   strings;
+
+        inline uint32_t mAdd( const node_t& cNode, uint32_t depth );
+        inline uint32_t mAddTree( const tree_t& cTree );
+    };
+
+    // Reads the records of an image, checking every index and offset against its size.
+    class reader_c final {
+    public:
+        inline uint32_t         mcGetNumTrees( void )                     const noexcept;
+        inline uint32_t         mcGetNumNodes( void )                     const noexcept;
+        inline treeRecord_t     mcGetTree( uint32_t iTree )               const;
+        inline nodeRecord_t     mcGetNode( uint32_t iNode )               const;
+        inline uint32_t         mcGetChild( uint32_t iChild )             const;
+        inline std::string_view mcGetName( const nodeRecord_t& cRecord ) const;
+
+        inline reader_c( const uint8_t* cpImage, size_t numBytes );
+
+    private:
+        const uint8_t* const mcpImage;
+        header_t             mHeader;
+        size_t               mNodesOffset;
+        size_t               mChildrenOffset;
+        size_t               mStringsOffset;
+
+        template< typename record_tt >
+        inline record_tt mcRead( size_t offset, uint32_t index, uint32_t count ) const;
+    };
+
+    // The file mapped to memory, or read into a buffer where it can't be mapped.
+    class file_c final {
+    public:
+        inline const uint8_t* mcGetData( void )     const noexcept;
+        inline size_t         mcGetNumBytes( void ) const noexcept;
+
+        file_c&         operator=( const file_c& ) = delete;
+        file_c&         operator=( file_c&& )      = delete;
+        explicit inline file_c( const std::string& cPath );
+                        file_c( const file_c& ) = delete;
+                        file_c( file_c&& )      = delete;
+        inline          ~file_c( void );
+
+    private:
+        const uint8_t*         mcpData { nullptr };
+        size_t                 mNumBytes { 0 };
+        bool                   mIsMapped { false };
+        std::vector< uint8_t > mBuffer;             // Unless mapped.
+    };
+
+    template< typename node_tt, typename function_tt >
+    inline image_c& mBind( nodeKind_t kind, std::string_view cName, function_tt&& function );
+
+    inline node_t* mcCreate( const reader_c& cReader, uint32_t iNode, uint32_t depth, tree_t& tree,
+                             const std::vector< std::shared_ptr< const tree_t > >& cTrees, std::vector< bool >& isUsed ) const;
+
+    std::unordered_map< std::string, binding_t > mBindings; // Leaves and lazy sub-trees by name.
+};
+
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename function_tt >
+inline auto image_c< timeData_t >::mDo( std::string_view cName, function_tt&& function ) ->image_c& {
+    return mBind< actionNode_c< timeData_t > >( nodeKind_t::ACTION, cName, std::forward< function_tt >( function ) );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename function_tt >
+inline auto image_c< timeData_t >::mCondition( std::string_view cName, function_tt&& function ) ->image_c& {
+    return mBind< conditionNode_c< timeData_t > >( nodeKind_t::CONDITION, cName, std::forward< function_tt >( function ) );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto image_c< timeData_t >::mSpliceLazy( std::string_view cName, factory_t factory ) ->image_c& {
+    if ( !factory ) {
+        SMD_FBT_THROW( "Can't create a lazy sub-tree without a factory." );
+    }
+
+    mBindings[ std::string( cName ) ] = binding_t {
+        nodeKind_t::LAZY_SUBTREE,
+        [ factory ]( tree_t& tree, std::string_view cNodeName, uint32_t stateCapacity ) -> node_t* {
+            return tree.template mCreate< lazySubtreeNode_c< timeData_t > >( cNodeName, factory, stateCapacity );
+        }
+    };
+
+    return *this;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto image_c< timeData_t >::mcLoad( const std::string& cPath ) const ->treePtr_t {
+    const file_c cFile( cPath );
+
+    return mcInstantiate( cFile.mcGetData(), cFile.mcGetNumBytes() );
+}
+
+//==============================================================================================================================
+// The spliced trees come after the trees that splice them, so they are created from the last one back to the first one.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto image_c< timeData_t >::mcInstantiate( const uint8_t* cpImage, size_t numBytes ) const ->treePtr_t {
+    const reader_c cReader( cpImage, numBytes );
+
+    std::vector< std::shared_ptr< const tree_t > > trees( cReader.mcGetNumTrees() );
+    std::vector< bool >                            isUsed( cReader.mcGetNumNodes() ); // Every record makes one node.
+    treePtr_t                                      pTree;
+
+    for ( uint32_t iTree = cReader.mcGetNumTrees(); iTree-- > 0; ) {
+        const treeRecord_t cRecord { cReader.mcGetTree( iTree ) };
+
+        pTree = std::make_unique< tree_t >();
+        pTree->mSetRoot( mcCreate( cReader, cRecord.iRoot, 0, *pTree, trees, isUsed ) );
+        pTree->mSetMemory( ( cRecord.flags & cHasMemory ) != 0 );
+        if ( cRecord.flags & cSharesGuards ) {
+            pTree->mSetGuardSharing( true );
+        }
+
+        if ( pTree->mcGetStateSize() != cRecord.stateSize ) {
+            SMD_FBT_THROW( "Can't load an image whose state is laid out differently, e.g. saved by another build." );
+        }
+
+        if ( iTree > 0 ) {
+            trees[ iTree ] = move( pTree );
+        }
+    }
+
+    return pTree;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline std::vector< uint8_t > image_c< timeData_t >::mFlatten( const tree_t& cTree ) {
+    writer_t writer;
+
+    writer.mAddTree( cTree );
+    for ( size_t iTree = 0; iTree < writer.trees.size(); ++iTree ) {
+        const tree_t& cNext { *writer.trees[ iTree ] };
+
+        if ( !cNext.mcIsCompact() ) {
+            SMD_FBT_THROW( "Can't flatten an edited tree, its state can't be laid out the same when loaded. Call 'mCompact' first." );
+        }
+
+        const uint32_t cFlags { ( cNext.mcHasMemory() ? cHasMemory : 0 ) | ( cNext.mcSharesGuards() ? cSharesGuards : 0 ) };
+        const uint32_t cRoot  { writer.mAdd( *cNext.mcGetRoot(), 0 ) };
+
+        writer.treeRecords.emplace_back( treeRecord_t { cRoot, cFlags, cNext.mcGetStateSize() } );
+    }
+
+    const header_t cHeader {
+        cMagic,
+        cVersion,
+        static_cast< uint32_t >( writer.treeRecords.size() ),
+        static_cast< uint32_t >( writer.nodes.size() ),
+        static_cast< uint32_t >( writer.children.size() ),
+        static_cast< uint32_t >( writer.strings.size() )
+    };
+
+    std::vector< uint8_t > image;
+    image.reserve( sizeof( header_t ) + writer.treeRecords.size() * sizeof( treeRecord_t ) +
+                   writer.nodes.size() * sizeof( nodeRecord_t ) + writer.children.size() * sizeof( uint32_t ) +
+                   writer.strings.size() );
+
+    auto append = [ &image ]( const void* cpData, size_t numBytes ) {
+        image.insert( image.end(), static_cast< const uint8_t* >( cpData ), static_cast< const uint8_t* >( cpData ) + numBytes );
+    };
+
+    append( &cHeader, sizeof( header_t ) );
+    append( writer.treeRecords.data(), writer.treeRecords.size() * sizeof( treeRecord_t ) );
+    append( writer.nodes.data(), writer.nodes.size() * sizeof( nodeRecord_t ) );
+    append( writer.children.data(), writer.children.size() * sizeof( uint32_t ) );
+    append( writer.strings.data(), writer.strings.size() );
+
+    return image;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void image_c< timeData_t >::mSave( const tree_t& cTree, const std::string& cPath ) {
+    const std::vector< uint8_t > cImage { mFlatten( cTree ) };
+
+    std::ofstream file( cPath, std::ios::binary | std::ios::trunc );
+    file.write( reinterpret_cast< const char* >( cImage.data() ), static_cast< std::streamsize >( cImage.size() ) );
+
+    if ( !file ) {
+        SMD_FBT_THROW( "Can't write the image file." );
+    }
+}
+
+//==============================================================================================================================
+// Children are recorded after their parent, so their records can't form a cycle. Trees nested deeper than 'cMaxDepth' aren't
+// flattened, as they couldn't be loaded.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t image_c< timeData_t >::writer_t::mAdd( const node_t& cNode, uint32_t depth ) {
+    if ( depth >= cMaxDepth ) {
+        SMD_FBT_THROW( "Can't flatten a tree nested deeper than 'cMaxDepth'." );
+    }
+
+    const uint32_t cIndex { static_cast< uint32_t >( nodes.size() ) };
+
+    nodeRecord_t record { static_cast< uint32_t >( cNode.mcKind ), static_cast< uint32_t >( strings.size() ),
+                          static_cast< uint32_t >( cNode.mcName.size() ), 0, 0, 0, 0 };
+    strings += cNode.mcName;
+
+    switch ( cNode.mcKind ) {
+        case nodeKind_t::PARALLEL: {
+            const auto& cParallel = static_cast< const parallelNode_c< timeData_t >& >( cNode );
+
+            record.arg0 = cParallel.mcGetNumToFail();
+            record.arg1 = cParallel.mcGetNumToSucceed();
+            break;
+        }
+        case nodeKind_t::WAIT:
+            record.arg0 = static_cast< const waitNode_c< timeData_t >& >( cNode ).mcEvent;
+            break;
+        case nodeKind_t::SUBTREE:
+            record.arg0 = mAddTree( static_cast< const subtreeNode_c< timeData_t >& >( cNode ).mcGetTree() );
+            nodes.emplace_back( record );
+            return cIndex;
+        case nodeKind_t::LAZY_SUBTREE:
+            record.arg0 = cNode.mcStateSize;
+            break;
+        case nodeKind_t::CONDITION:
+            record.arg0 = static_cast< const conditionNode_c< timeData_t >& >( cNode ).mcIsShared;
+            break;
+        default:
+            break;
+    }
+
+    nodes.emplace_back( record );
+
+    std::vector< uint32_t > childRecords;
+    childRecords.reserve( cNode.mcGetNumChildren() );
+    for ( const node_t* cpChild : cNode.mcGetChildren() ) {
+        childRecords.emplace_back( mAdd( *cpChild, depth + 1 ) );
+    }
+
+    nodes[ cIndex ].firstChild  = static_cast< uint32_t >( children.size() );
+    nodes[ cIndex ].numChildren = static_cast< uint32_t >( childRecords.size() );
+    children.insert( children.end(), childRecords.begin(), childRecords.end() );
+
+    return cIndex;
+}
+
+//==============================================================================================================================
+// Returns the index of the tree in the image, a tree spliced more than once is stored once.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t image_c< timeData_t >::writer_t::mAddTree( const tree_t& cTree ) {
+    const auto [ cIt, cIsNew ] = treeIndices.emplace( &cTree, static_cast< uint32_t >( trees.size() ) );
+
+    if ( cIsNew ) {
+        trees.emplace_back( &cTree );
+    }
+
+    return cIt->second;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t image_c< timeData_t >::reader_c::mcGetNumTrees( void ) const noexcept {
+    return mHeader.numTrees;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t image_c< timeData_t >::reader_c::mcGetNumNodes( void ) const noexcept {
+    return mHeader.numNodes;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto image_c< timeData_t >::reader_c::mcGetTree( uint32_t iTree ) const ->treeRecord_t {
+    return mcRead< treeRecord_t >( sizeof( header_t ), iTree, mHeader.numTrees );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto image_c< timeData_t >::reader_c::mcGetNode( uint32_t iNode ) const ->nodeRecord_t {
+    return mcRead< nodeRecord_t >( mNodesOffset, iNode, mHeader.numNodes );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t image_c< timeData_t >::reader_c::mcGetChild( uint32_t iChild ) const {
+    return mcRead< uint32_t >( mChildrenOffset, iChild, mHeader.numChildren );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline std::string_view image_c< timeData_t >::reader_c::mcGetName( const nodeRecord_t& cRecord ) const {
+    if ( uint64_t { cRecord.nameOffset } + cRecord.nameSize > mHeader.numStringBytes ) {
+        SMD_FBT_THROW( "Can't load a corrupt image, a name is out of the string table." );
+    }
+
+    return std::string_view( reinterpret_cast< const char* >( mcpImage + mStringsOffset + cRecord.nameOffset ),
+                             cRecord.nameSize );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline image_c< timeData_t >::reader_c::reader_c( const uint8_t* cpImage, size_t numBytes ) :
+    mcpImage( cpImage ),
+    mHeader {},
+    mNodesOffset( 0 ),
+    mChildrenOffset( 0 ),
+    mStringsOffset( 0 ) {
+    if ( !cpImage || numBytes < sizeof( header_t ) ) {
+        SMD_FBT_THROW( "Can't load an image that is too small." );
+    }
+
+    std::memcpy( &mHeader, cpImage, sizeof( header_t ) );
+
+    if ( mHeader.magic != cMagic || mHeader.version != cVersion ) {
+        SMD_FBT_THROW( "Can't load an image of another format or version." );
+    }
+    if ( mHeader.numTrees == 0 ) {
+        SMD_FBT_THROW( "Can't load an image without trees." );
+    }
+
+    mNodesOffset    = sizeof( header_t ) + size_t { mHeader.numTrees } * sizeof( treeRecord_t );
+    mChildrenOffset = mNodesOffset + size_t { mHeader.numNodes } * sizeof( nodeRecord_t );
+    mStringsOffset  = mChildrenOffset + size_t { mHeader.numChildren } * sizeof( uint32_t );
+
+    if ( mStringsOffset + mHeader.numStringBytes != numBytes ) {
+        SMD_FBT_THROW( "Can't load a corrupt image, its size doesn't match the header." );
+    }
+}
+
+//==============================================================================================================================
+// Records are copied out, so the image doesn't have to be aligned.
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename record_tt >
+inline record_tt image_c< timeData_t >::reader_c::mcRead( size_t offset, uint32_t index, uint32_t count ) const {
+    if ( index >= count ) {
+        SMD_FBT_THROW( "Can't load a corrupt image, a record is out of range." );
+    }
+
+    record_tt record;
+    std::memcpy( &record, mcpImage + offset + size_t { index } * sizeof( record_tt ), sizeof( record_tt ) );
+
+    return record;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline const uint8_t* image_c< timeData_t >::file_c::mcGetData( void ) const noexcept {
+    return mcpData;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t image_c< timeData_t >::file_c::mcGetNumBytes( void ) const noexcept {
+    return mNumBytes;
+}
+
+//==============================================================================================================================
+// Maps the file where the platform can, falls back to reading it, e.g. for files on a pipe or for empty files.
+//==============================================================================================================================
+template< typename timeData_t >
+inline image_c< timeData_t >::file_c::file_c( const std::string& cPath ) {
+#if defined( __unix__ ) || defined( __APPLE__ )
+    const int cFile { ::open( cPath.c_str(), O_RDONLY ) };
+
+    if ( cFile < 0 ) {
+        SMD_FBT_THROW( "Can't open the image file." );
+    }
+
+    struct stat info;
+
+    if ( ::fstat( cFile, &info ) == 0 && info.st_size > 0 ) {
+        void* const cpMapped { ::mmap( nullptr, static_cast< size_t >( info.st_size ), PROT_READ, MAP_PRIVATE, cFile, 0 ) };
+
+        if ( cpMapped != MAP_FAILED ) {
+            mcpData   = static_cast< const uint8_t* >( cpMapped );
+            mNumBytes = static_cast< size_t >( info.st_size );
+            mIsMapped = true;
+        }
+    }
+
+    if ( !mIsMapped ) {
+        uint8_t chunk[ 4096 ];
+        ssize_t numRead;
+
+        while ( ( numRead = ::read( cFile, chunk, sizeof( chunk ) ) ) > 0 ) {
+            mBuffer.insert( mBuffer.end(), chunk, chunk + numRead );
+        }
+
+        mcpData   = mBuffer.data();
+        mNumBytes = mBuffer.size();
+    }
+
+    ::close( cFile );
+#else
+    std::ifstream file( cPath, std::ios::binary );
+
+    if ( !file ) {
+        SMD_FBT_THROW( "Can't open the image file." );
+    }
+
+    mBuffer.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+    mcpData   = mBuffer.data();
+    mNumBytes = mBuffer.size();
+#endif
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline image_c< timeData_t >::file_c::~file_c( void ) {
+#if defined( __unix__ ) || defined( __APPLE__ )
+    if ( mIsMapped ) {
+        ::munmap( const_cast< uint8_t* >( mcpData ), mNumBytes );
+    }
+#endif
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename node_tt, typename function_tt >
+inline auto image_c< timeData_t >::mBind( nodeKind_t kind, std::string_view cName, function_tt&& function ) ->image_c& {
+    using function_t = std::conditional_t< std::is_invocable_v< function_tt, const context_t& >,
+                                           typename node_tt::contextFunction_t,
+                                           typename node_tt::function_t >;
+
+    function_t leafFunction( std::forward< function_tt >( function ) );
+
+    if ( !leafFunction ) {
+        SMD_FBT_THROW( "Can't create a leaf node with an empty function." );
+    }
+
+    mBindings[ std::string( cName ) ] = binding_t {
+        kind,
+        [ leafFunction ]( tree_t& tree, std::string_view cNodeName, uint32_t arg0 ) -> node_t* {
+            if constexpr ( std::is_same_v< node_tt, conditionNode_c< timeData_t > > ) {
+                return tree.template mCreate< node_tt >( cNodeName, leafFunction, arg0 != 0 );
+            } else {
+                return tree.template mCreate< node_tt >( cNodeName, leafFunction );
+            }
+        }
+    };
+
+    return *this;
+}
+
+//==============================================================================================================================
+// Creates the node of a record and its descendants in the tree. Children come after their parent and every record is used
+// once, so a corrupt image can't make a cycle or share a node between parents, and the recursion ends. Its depth is capped at
+// 'cMaxDepth', so a corrupt image can't overflow the stack either.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto image_c< timeData_t >::mcCreate( const reader_c& cReader, uint32_t iNode, uint32_t depth, tree_t& tree,
+                                             const std::vector< std::shared_ptr< const tree_t > >& cTrees,
+                                             std::vector< bool >& isUsed ) const ->node_t* {
+    if ( depth >= cMaxDepth ) {
+        SMD_FBT_THROW( "Can't load a corrupt image, the nodes are nested deeper than 'cMaxDepth'." );
+    }
+
+    const nodeRecord_t cRecord { cReader.mcGetNode( iNode ) };
+
+    if ( isUsed[ iNode ] ) {
+        SMD_FBT_THROW( "Can't load a corrupt image, a node is used more than once." );
+    }
+    isUsed[ iNode ] = true;
+
+    const std::string_view cName { cReader.mcGetName( cRecord ) };
+    const nodeKind_t       cKind { static_cast< nodeKind_t >( cRecord.kind ) };
+
+    parentNode_i< timeData_t >* pParent { nullptr };
+
+    switch ( cKind ) {
+        case nodeKind_t::ACTION:
+        case nodeKind_t::CONDITION:
+        case nodeKind_t::LAZY_SUBTREE: {
+            const auto cIt = mBindings.find( std::string( cName ) );
+
+            if ( cIt == mBindings.end() || cIt->second.kind != cKind ) {
+                SMD_FBT_THROW( "Can't load an image with a leaf that isn't bound to a function." );
+            }
+
+            return cIt->second.create( tree, cName, cRecord.arg0 );
+        }
+        case nodeKind_t::WAIT:
+            return tree.template mCreate< waitNode_c< timeData_t > >( cName, cRecord.arg0 );
+        case nodeKind_t::SUBTREE:
+            if ( cRecord.arg0 >= cTrees.size() || !cTrees[ cRecord.arg0 ] ) {
+                SMD_FBT_THROW( "Can't load a corrupt image, a spliced tree is out of order." );
+            }
+
+            return tree.template mCreate< subtreeNode_c< timeData_t > >( cTrees[ cRecord.arg0 ] );
+        case nodeKind_t::INVERTER:
+            pParent = tree.template mCreate< inverterNode_c< timeData_t > >( cName );
+            break;
+        case nodeKind_t::PARALLEL:
+            pParent = tree.template mCreate< parallelNode_c< timeData_t > >( cName, cRecord.arg0, cRecord.arg1 );
+            break;
+        case nodeKind_t::REACTIVE_SELECTOR:
+            pParent = tree.template mCreate< reactiveSelectorNode_c< timeData_t > >( cName );
+            break;
+        case nodeKind_t::SELECTOR:
+            pParent = tree.template mCreate< selectorNode_c< timeData_t > >( cName );
+            break;
+        case nodeKind_t::SEQUENCE:
+            pParent = tree.template mCreate< sequenceNode_c< timeData_t > >( cName );
+            break;
+        default:
+            SMD_FBT_THROW( "Can't load a corrupt image, a node is of an unknown kind." );
+    }
+
+    for ( uint32_t iChild = 0; iChild < cRecord.numChildren; ++iChild ) {
+        const uint32_t cChild { cReader.mcGetChild( cRecord.firstChild + iChild ) };
+
+        if ( cChild <= iNode ) {
+            SMD_FBT_THROW( "Can't load a corrupt image, a child comes before its parent." );
+        }
+
+        pParent->mAddChild( mcCreate( cReader, cChild, depth + 1, tree, cTrees, isUsed ) );
+    }
+
+    if ( !pParent->mcIsComplete() ) {
+        SMD_FBT_THROW( "Can't load a corrupt image, a node misses its children." );
+    }
+
+    return pParent;
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,258 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "snapshot.hpp"
+#include "tree_c.hpp"
+
+#include <new>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// One agent running a shared tree. The tree is immutable, the instance only owns the state block, so any number of agents
+// can run the same tree at the cost of a few bytes each. The allocator of the state block lets a runtime keep the state of its
+// agents in memory of its own, e.g. 'partitionedTicker_c' places it in the arena of the thread that ticks the agent.
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t = std::allocator< stateWord_t > >
+class instance_c final {
+    using tree_t    = tree_c< timeData_t >;
+    using treePtr_t = std::shared_ptr< const tree_t >;
+    using context_t = tickContext_t< timeData_t >;
+
+public:
+    inline status_t mTick( param_t< timeData_t > timeData, profiler_c* pProfiler = nullptr )       noexcept;
+    inline status_t mTick( context_t& context )                                                    noexcept; // Sets the state and agent.
+    inline void     mReset( void )                                                                 noexcept; // As a fresh instance.
+    inline void     mRestore( const stateWord_t* cpSnapshot )                                      noexcept;
+    inline void     mcSnapshot( stateWord_t* pSnapshot )                                     const noexcept;
+    inline void     mSync( void );                                                                           // After edits of the tree.
+    inline void     mSetAgent( void* pAgent )                                                      noexcept; // Passed to the leaves as 'pAgent'.
+
+    inline status_t mTick( param_t< timeData_t > timeData, const tickBudget_t& cBudget, profiler_c* pProfiler = nullptr ) noexcept;
+
+    inline const tree_t&  mcGetTree( void )      const noexcept;
+    inline uint8_t*       mGetState( void )            noexcept; // Writes through it are seen by the next tick.
+    inline const uint8_t* mcGetState( void )     const noexcept;
+    inline uint32_t       mcGetStateSize( void ) const noexcept;
+    inline size_t         mcGetNumWords( void )  const noexcept; // Size of a snapshot in words.
+    inline void*          mcGetAgent( void )     const noexcept;
+    inline bool           mcIsSuspended( void )  const noexcept; // Whether the last tick ran out of budget.
+
+    instance_c&     operator=( const instance_c& ) = default;
+    instance_c&     operator=( instance_c&& )      noexcept = default;
+    explicit inline instance_c( treePtr_t pTree, const allocator_t& cAllocator = allocator_t() );
+    inline          instance_c( const instance_c& cOther, const allocator_t& cAllocator ); // With the state in other memory.
+                    instance_c( const instance_c& ) = default;
+                    instance_c( instance_c&& )      noexcept = default;
+                    ~instance_c( void )             = default;
+
+private:
+    inline bool mTrySync( void ) noexcept; // Whether the state could be allocated.
+
+    treePtr_t                               mpTree;                // Tree the instance runs.
+    std::vector< stateWord_t, allocator_t > mState;                // State of the instance, laid out by the tree.
+    uint32_t                                mRevision { 0 };       // Revision of the tree the state is laid out for.
+    void*                                   mpAgent   { nullptr }; // Agent the instance belongs to, if any.
+    activePath_c< timeData_t >              mPath;                 // Running path of 'mState' if the tree has memory.
+};
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline status_t instance_c< timeData_t, allocator_t >::mTick( param_t< timeData_t > timeData, profiler_c* pProfiler ) noexcept {
+    context_t context { timeData, nullptr, pProfiler };
+
+    return mTick( context );
+}
+
+//==============================================================================================================================
+// A time-sliced tick, it suspends when the budget runs out and returns RUNNING with 'mcIsSuspended()' set. The next tick,
+// sliced or not, continues the suspended traversal instead of starting at the root, so a large tree can be ticked across
+// several frames.
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline status_t instance_c< timeData_t, allocator_t >::mTick( param_t< timeData_t > timeData, const tickBudget_t& cBudget,
+                                                            profiler_c* pProfiler ) noexcept {
+    tickSlice_t< timeData_t > slice { startSlice< timeData_t >( cBudget ) };
+    context_t                 context { timeData, nullptr, pProfiler };
+
+    context.pSlice = &slice;
+
+    return mTick( context );
+}
+
+//==============================================================================================================================
+// Ticks with a context prepared by the caller, e.g. 'scheduler_c' passes the event that woke the instance up and reads the
+// event it waits for from it. The caller may also set its own scratch memory, it's rewound when the tick returns as well. A
+// tick that has to sync the state after an edit and runs out of memory fails, the next tick tries to sync again.
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline status_t instance_c< timeData_t, allocator_t >::mTick( context_t& context ) noexcept {
+    const profileSpan_c  cSpan( context.pProfiler, mpTree->mcGetRoot()->mcName, "tree" );
+    const scratchScope_c cScratch( context.pScratch );
+
+    if ( mRevision != mpTree->mcGetRevision() && !mTrySync() ) {
+        return status_t::FAILURE;
+    }
+
+    context.pState = reinterpret_cast< uint8_t* >( mState.data() );
+    context.pAgent = mpAgent;
+    mpTree->mcStampTick( context );
+
+    if ( mpTree->mcHasMemory() || context.pSlice || mPath.mcIsSuspended() ) {
+        return mPath.mTick( *mpTree->mcGetRoot(), context, mpTree->mcHasMemory() );
+    }
+
+    return mpTree->mcGetRoot()->mTick( context );
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline void instance_c< timeData_t, allocator_t >::mReset( void ) noexcept {
+    std::fill( mState.begin(), mState.end(), 0 );
+    mPath.mInvalidate();
+}
+
+//==============================================================================================================================
+// The snapshot must have been taken from an instance of the same tree.
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline void instance_c< timeData_t, allocator_t >::mRestore( const stateWord_t* cpSnapshot ) noexcept {
+    std::memcpy( mState.data(), cpSnapshot, mState.size() * sizeof( stateWord_t ) );
+    mPath.mInvalidate();
+}
+
+//==============================================================================================================================
+// Copies the state to a buffer of 'mcGetNumWords()' words, e.g. a slot of a rollback ring.
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline void instance_c< timeData_t, allocator_t >::mcSnapshot( stateWord_t* pSnapshot ) const noexcept {
+    std::memcpy( pSnapshot, mState.data(), mState.size() * sizeof( stateWord_t ) );
+}
+
+//==============================================================================================================================
+// Ticking syncs the state too, but syncing right after the edit keeps allocations out of the tick.
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline void instance_c< timeData_t, allocator_t >::mSync( void ) {
+    mpTree->mcUpdateState( mState, mRevision );
+    mRevision = mpTree->mcGetRevision();
+    mPath.mInvalidate();
+}
+
+//==============================================================================================================================
+// Without exceptions running out of memory aborts anyway.
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline bool instance_c< timeData_t, allocator_t >::mTrySync( void ) noexcept {
+#ifdef SMD_FBT_NO_EXCEPTIONS
+    mSync();
+#else
+    try {
+        mSync();
+    } catch ( const std::bad_alloc& ) {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline void instance_c< timeData_t, allocator_t >::mSetAgent( void* pAgent ) noexcept {
+    mpAgent = pAgent;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline auto instance_c< timeData_t, allocator_t >::mcGetTree( void ) const noexcept ->const tree_t& {
+    return *mpTree;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline uint8_t* instance_c< timeData_t, allocator_t >::mGetState( void ) noexcept {
+    mPath.mInvalidate();
+
+    return reinterpret_cast< uint8_t* >( mState.data() );
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline const uint8_t* instance_c< timeData_t, allocator_t >::mcGetState( void ) const noexcept {
+    return reinterpret_cast< const uint8_t* >( mState.data() );
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline uint32_t instance_c< timeData_t, allocator_t >::mcGetStateSize( void ) const noexcept {
+    return mpTree->mcGetStateSize();
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline size_t instance_c< timeData_t, allocator_t >::mcGetNumWords( void ) const noexcept {
+    return mState.size();
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline void* instance_c< timeData_t, allocator_t >::mcGetAgent( void ) const noexcept {
+    return mpAgent;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline bool instance_c< timeData_t, allocator_t >::mcIsSuspended( void ) const noexcept {
+    return mPath.mcIsSuspended();
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline instance_c< timeData_t, allocator_t >::instance_c( treePtr_t pTree, const allocator_t& cAllocator ) :
+    mpTree( move( pTree ) ),
+    mState( cAllocator ) {
+    if ( !mpTree || !mpTree->mcGetRoot() ) {
+        SMD_FBT_THROW( "Can't create an instance of an empty tree." );
+    }
+
+    mSync();
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename allocator_t >
+inline instance_c< timeData_t, allocator_t >::instance_c( const instance_c& cOther, const allocator_t& cAllocator ) :
+    mpTree( cOther.mpTree ),
+    mState( cOther.mState, cAllocator ),
+    mRevision( cOther.mRevision ),
+    mpAgent( cOther.mpAgent ),
+    mPath( cOther.mPath ) {
+}
+
+} // namespace smd::fbt
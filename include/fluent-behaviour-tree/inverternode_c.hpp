@@ -28,6 +28,7 @@
 #include "common.hpp"
 #include "node_i.hpp"
 #include "parentnode_i.hpp"
+#include "statuslanes.hpp"
 
 namespace smd::fbt {
 
@@ -37,60 +38,55 @@ namespace smd::fbt {
 template< typename timeData_t >
 class inverterNode_c final : public parentNode_i< timeData_t > {
     using parentNode_t = parentNode_i< timeData_t >;
-    using nodePtr_t    = std::shared_ptr< node_i< timeData_t > >;
+    using context_t    = typename parentNode_t::context_t;
 
 public:
-    inline status_t mTick( timeData_t time )      override;
-    inline void     mAddChild( nodePtr_t pChild ) override;
+    inline status_t mTick( context_t& context )                                        const noexcept override;
+    inline status_t mResume( context_t& context, uint32_t iChild, status_t childStatus ) const noexcept override;
+    inline uint32_t mcGetResumeChild( const context_t& cContext )                       const noexcept override;
 
     inverterNode_c& operator=( const inverterNode_c& ) = delete;
     inverterNode_c& operator=( inverterNode_c&& )      noexcept = delete;
-    explicit inline inverterNode_c( const std::string& cName );
+    explicit inline inverterNode_c( std::string_view cName );
     inline          inverterNode_c( const inverterNode_c& cNode );
-                    inverterNode_c( inverterNode_c&& ) noexcept = delete;
+    inline          inverterNode_c( inverterNode_c&& node );
                     ~inverterNode_c( void )            = default;
 
 private:
-    nodePtr_t mpChild;
+    using parentNode_t::mChildren;
 };
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline status_t inverterNode_c< timeData_t >::mTick( timeData_t time ) {
-    if ( !mpChild ) {
-        throw except_c( "'inverterNode_c' must have a child node!" );
-    }
-
-    const status_t cResult { mpChild->mTick( time ) };
-
-    if ( cResult == status_t::FAILURE ) {
-        return status_t::SUCCESS;
-    } else if ( cResult == status_t::SUCCESS ) {
-        return status_t::FAILURE;
-    } else {
-        return cResult;
-    }
+inline status_t inverterNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    return invertStatus( mChildren.front()->mTick( context ) );
 }
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline void inverterNode_c< timeData_t >::mAddChild( nodePtr_t pChild ) {
-    if ( mpChild ) {
-        throw except_c( "Can't add more than a single child to 'inverterNode_c'!" );
-    }
+inline status_t inverterNode_c< timeData_t >::mResume( context_t&, uint32_t, status_t childStatus ) const noexcept {
+    return invertStatus( childStatus );
+}
 
-    mpChild = move( pChild );
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t inverterNode_c< timeData_t >::mcGetResumeChild( const context_t& ) const noexcept {
+    return 0;
 }
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline inverterNode_c< timeData_t >::inverterNode_c( const std::string& cName ) :
-    parentNode_t( cName ) {}
+inline inverterNode_c< timeData_t >::inverterNode_c( std::string_view cName ) :
+    parentNode_t( nodeKind_t::INVERTER, cName, 1 ) {}
 
 //==============================================================================================================================
 template< typename timeData_t >
 inline inverterNode_c< timeData_t >::inverterNode_c( const inverterNode_c& cNode ) :
-    parentNode_t( cNode ),
-    mpChild( cNode.mpChild ) {}
+    parentNode_t( cNode ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline inverterNode_c< timeData_t >::inverterNode_c( inverterNode_c&& node ) :
+    parentNode_t( std::move( node ) ) {}
 
 } // namespace smd::fbt
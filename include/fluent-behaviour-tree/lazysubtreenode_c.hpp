@@ -0,0 +1,268 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "tree_c.hpp"
+
+#include <atomic>
+#include <mutex>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Splices a sub-tree that is built only when it's ticked for the first time, e.g. a rare emergency behaviour most agents
+// never enter. The factory builds the sub-tree, or loads it, and must build the same tree every time. The state of the
+// sub-tree must fit in the capacity declared up front, since the state of the parent tree is laid out before the sub-tree
+// exists. The factory runs under a lock, a tick that finds another thread building fails instead of waiting for it. A sub-tree
+// that doesn't fit fails every tick from then on, a factory that throws or returns nothing only fails the tick and runs again
+// on the next one. 'mcBuild' (or 'buildLazySubtrees' for a whole tree) reports either with an error instead, e.g. right after
+// the tree is built or loaded.
+//
+// To the rest of the tree the node is a leaf: passes don't see the sub-tree, a resumed or time-sliced tick ticks the node as
+// a whole, and the composites of the sub-tree resume from their own state. 'mcReleaseIdle' drops the sub-tree again when it
+// hasn't been ticked for a while, the state of the agents stays valid, so an agent continues where it was when the sub-tree is
+// built the next time. The built sub-tree is a cache of what the factory returns, not a part of the node, so building and
+// releasing it are const, through 'mutable' members, and work on the nodes of a shared const tree.
+//==============================================================================================================================
+template< typename timeData_t >
+class lazySubtreeNode_c final : public node_i< timeData_t > {
+    using node_t    = node_i< timeData_t >;
+    using context_t = typename node_t::context_t;
+    using treePtr_t = std::shared_ptr< const tree_c< timeData_t > >;
+
+public:
+    using factory_t = std::function< treePtr_t( void ) >;
+
+    inline status_t mTick( context_t& context ) const noexcept override;
+
+    inline const node_t* mcBuild( void )       const;          // Builds the sub-tree now unless it's built, returns its root.
+    inline bool          mcReleaseIdle( void ) const noexcept; // Not while ticking, see 'releaseIdleSubtrees'.
+    inline bool          mcIsBuilt( void )     const noexcept;
+
+    inline bool mcHasSameFunction( const lazySubtreeNode_c& cOther ) const noexcept; // Of the factory, see 'isSameFunction'.
+
+    lazySubtreeNode_c& operator=( const lazySubtreeNode_c& ) = delete;
+    lazySubtreeNode_c& operator=( lazySubtreeNode_c&& )      noexcept = delete;
+    inline             lazySubtreeNode_c( std::string_view cName, factory_t factory, uint32_t stateCapacity );
+    inline             lazySubtreeNode_c( const lazySubtreeNode_c& cNode );
+    inline             lazySubtreeNode_c( lazySubtreeNode_c&& node );
+                       ~lazySubtreeNode_c( void ) = default;
+
+private:
+    inline const node_t* mcBuildLocked( void ) const noexcept; // Null if the sub-tree can't be built, 'mMutex' is held.
+
+    const factory_t                      mcFactory;             // Builds the sub-tree.
+    mutable std::mutex                   mMutex;                // Guards 'mpTree'.
+    mutable treePtr_t                    mpTree;                // Null until built and after it's released.
+    mutable std::atomic< const node_t* > mpRoot { nullptr };    // Root of 'mpTree' once built.
+    mutable std::atomic< bool >          mIsIdle { true };      // Not ticked since the last 'mcReleaseIdle'.
+    mutable std::atomic< bool >          mDoesntFit { false };  // The state of the sub-tree exceeds the capacity, final.
+};
+
+//==============================================================================================================================
+// The sub-tree ticks relative to the state of this node, without a time slice, as a leaf can't be suspended in the middle.
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t lazySubtreeNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    const node_t* cpRoot { mpRoot.load( std::memory_order_acquire ) };
+
+    if ( !cpRoot ) {
+        if ( mDoesntFit.load( std::memory_order_relaxed ) ) {
+            return status_t::FAILURE;
+        }
+
+        const std::unique_lock< std::mutex > cLock( mMutex, std::try_to_lock );
+
+        if ( !cLock.owns_lock() || !( cpRoot = mcBuildLocked() ) ) {
+            return status_t::FAILURE;
+        }
+    }
+
+    if ( mIsIdle.load( std::memory_order_relaxed ) ) {
+        mIsIdle.store( false, std::memory_order_relaxed );
+    }
+
+    uint8_t* const                   cpState { context.pState };
+    tickSlice_t< timeData_t >* const cpSlice { context.pSlice };
+
+    context.pState += node_t::mcGetStateOffset();
+    context.pSlice  = nullptr;
+    const status_t cStatus { cpRoot->mTick( context ) };
+    context.pState  = cpState;
+    context.pSlice  = cpSlice;
+
+    return cStatus;
+}
+
+//==============================================================================================================================
+// Reports a sub-tree the ticks can't build, a tick only fails. Waits for a build in progress on another thread.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto lazySubtreeNode_c< timeData_t >::mcBuild( void ) const ->const node_t* {
+    const node_t* cpRoot { mpRoot.load( std::memory_order_acquire ) };
+
+    if ( !cpRoot && !mDoesntFit.load( std::memory_order_relaxed ) ) {
+        const std::lock_guard< std::mutex > cLock( mMutex );
+        cpRoot = mcBuildLocked();
+    }
+
+    if ( !cpRoot ) {
+        SMD_FBT_THROW( "Can't build a lazy sub-tree, the factory failed or the state doesn't fit the capacity." );
+    }
+
+    return cpRoot;
+}
+
+//==============================================================================================================================
+// Releases the sub-tree if it hasn't been ticked since the last call, returns whether it was released. Call it every now and
+// then between ticks, the period is the time a sub-tree stays idle before it's released.
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool lazySubtreeNode_c< timeData_t >::mcReleaseIdle( void ) const noexcept {
+    if ( !mIsIdle.exchange( true, std::memory_order_relaxed ) || !mpRoot.load( std::memory_order_relaxed ) ) {
+        return false;
+    }
+
+    const std::unique_lock< std::mutex > cLock( mMutex, std::try_to_lock );
+
+    if ( !cLock.owns_lock() ) {
+        return false; // Being built, it's released by a later call.
+    }
+
+    mpRoot.store( nullptr, std::memory_order_relaxed );
+    mpTree.reset();
+
+    return true;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool lazySubtreeNode_c< timeData_t >::mcIsBuilt( void ) const noexcept {
+    return mpRoot.load( std::memory_order_acquire ) != nullptr;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool lazySubtreeNode_c< timeData_t >::mcHasSameFunction( const lazySubtreeNode_c& cOther ) const noexcept {
+    return isSameFunction( mcFactory, cOther.mcFactory );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline lazySubtreeNode_c< timeData_t >::lazySubtreeNode_c( std::string_view cName, factory_t factory, uint32_t stateCapacity ) :
+    node_t( nodeKind_t::LAZY_SUBTREE, cName, stateCapacity ),
+    mcFactory( move( factory ) ) {
+    if ( !mcFactory ) {
+        SMD_FBT_THROW( "Can't create a lazy sub-tree without a factory." );
+    }
+}
+
+//==============================================================================================================================
+// The copy builds the sub-tree again when it's ticked.
+//==============================================================================================================================
+template< typename timeData_t >
+inline lazySubtreeNode_c< timeData_t >::lazySubtreeNode_c( const lazySubtreeNode_c& cNode ) :
+    node_t( cNode ),
+    mcFactory( cNode.mcFactory ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline lazySubtreeNode_c< timeData_t >::lazySubtreeNode_c( lazySubtreeNode_c&& node ) :
+    node_t( std::move( node ) ),
+    mcFactory( node.mcFactory ) {}
+
+//==============================================================================================================================
+// Only a sub-tree that doesn't fit is final, the factory builds the same tree every time. A factory that throws or returns
+// nothing may succeed later, e.g. once a file can be read, so it's called again by the next build.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto lazySubtreeNode_c< timeData_t >::mcBuildLocked( void ) const noexcept ->const node_t* {
+    if ( mpTree || mDoesntFit.load( std::memory_order_relaxed ) ) {
+        return mpTree ? mpTree->mcGetRoot() : nullptr;
+    }
+
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    try {
+#endif
+        treePtr_t pTree { mcFactory() };
+
+        if ( pTree && pTree->mcGetRoot() && pTree->mcGetStateSize() > node_t::mcStateSize ) {
+            mDoesntFit.store( true, std::memory_order_relaxed );
+
+        } else if ( pTree && pTree->mcGetRoot() ) {
+            mpTree = move( pTree );
+            mpRoot.store( mpTree->mcGetRoot(), std::memory_order_release );
+        }
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    } catch ( ... ) {
+    }
+#endif
+
+    return mpTree ? mpTree->mcGetRoot() : nullptr;
+}
+
+//==============================================================================================================================
+// Builds the lazy sub-trees of a tree, and of the trees it splices, now. Reports the first one that can't be built, e.g. in a
+// tool or a test right after the tree is built or loaded, 'releaseIdleSubtrees' drops them again.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void buildLazySubtrees( const tree_c< timeData_t >& cTree ) {
+    std::vector< const lazySubtreeNode_c< timeData_t >* > lazyNodes;
+
+    cTree.mcGetRoot()->mcVisit( [ &lazyNodes ]( const node_i< timeData_t >& cNode, uint32_t ) {
+        if ( cNode.mcKind == nodeKind_t::LAZY_SUBTREE ) {
+            lazyNodes.emplace_back( &static_cast< const lazySubtreeNode_c< timeData_t >& >( cNode ) );
+        }
+
+        return true;
+    } );
+
+    for ( const lazySubtreeNode_c< timeData_t >* cpNode : lazyNodes ) {
+        cpNode->mcBuild();
+    }
+}
+
+//==============================================================================================================================
+// Releases the idle lazy sub-trees of a tree, and of the trees it splices, returns how many were released.
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t releaseIdleSubtrees( const tree_c< timeData_t >& cTree ) noexcept {
+    size_t numReleased { 0 };
+
+    cTree.mcGetRoot()->mcVisit( [ &numReleased ]( const node_i< timeData_t >& cNode, uint32_t ) {
+        if ( cNode.mcKind == nodeKind_t::LAZY_SUBTREE ) {
+            numReleased += static_cast< const lazySubtreeNode_c< timeData_t >& >( cNode ).mcReleaseIdle();
+        }
+
+        return true;
+    } );
+
+    return numReleased;
+}
+
+} // namespace smd::fbt
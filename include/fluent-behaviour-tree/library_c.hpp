@@ -0,0 +1,169 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "actionnode_c.hpp"
+#include "conditionnode_c.hpp"
+#include "lazysubtreenode_c.hpp"
+#include "tree_c.hpp"
+#include "structure.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Named sub-trees for common behaviours like "flee" or "patrol". Every behaviour is built once and stored once, any number of
+// trees splice it by name and share the same nodes, the state of each use lives in the state block of the splicing tree.
+// Trees built many times over, e.g. per agent type, can be interned so structurally identical ones share one tree. Leaves of
+// the same names are only merged when they run the same functions as far as 'isSameFunction' tells: closures of the same
+// lambda are taken as the same function, so interned trees must not tell their leaves apart by the captures alone.
+//==============================================================================================================================
+template< typename timeData_t >
+class library_c final {
+    using tree_t = tree_c< timeData_t >;
+    using node_t = node_i< timeData_t >;
+
+public:
+    using treePtr_t = std::shared_ptr< const tree_t >;
+
+    inline const treePtr_t& mDefine( std::string_view cName, std::unique_ptr< tree_t > pTree );
+    inline treePtr_t        mIntern( treePtr_t pTree ); // Returns an identical tree interned before, or interns this one.
+
+    inline const treePtr_t& mcGet( std::string_view cName ) const;
+    inline bool             mcHas( std::string_view cName ) const noexcept;
+    inline size_t           mcGetNumTrees( void )           const noexcept;
+    inline size_t           mcGetNumInterned( void )        const noexcept;
+
+    library_c&      operator=( const library_c& ) = delete;
+    library_c&      operator=( library_c&& )      noexcept = default;
+                    library_c( void )             = default;
+                    library_c( const library_c& ) = delete;
+                    library_c( library_c&& )      noexcept = default;
+                    ~library_c( void )            = default;
+
+private:
+    static inline bool mHaveSameFunctions( const node_t& cA, const node_t& cB ) noexcept; // Of structurally identical trees.
+
+    std::map< std::string, treePtr_t, std::less<> > mTrees;    // Behaviours by name.
+    std::unordered_multimap< uint64_t, treePtr_t >  mInterned; // Interned trees by their structural hash.
+};
+
+//==============================================================================================================================
+// The tree becomes immutable, it can't be changed once other trees may have spliced it.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto library_c< timeData_t >::mDefine( std::string_view cName, std::unique_ptr< tree_t > pTree ) ->const treePtr_t& {
+    if ( !pTree || !pTree->mcGetRoot() ) {
+        SMD_FBT_THROW( "Can't define a behaviour with an empty tree." );
+    }
+    if ( mcHas( cName ) ) {
+        SMD_FBT_THROW( "Can't define a behaviour twice, the name is already in the library." );
+    }
+
+    return mTrees.emplace( cName, move( pTree ) ).first->second;
+}
+
+//==============================================================================================================================
+// Trees of the same hash are compared node by node, kinds, names and parameters, so a hash collision never merges trees of
+// different structures, then by the functions of their leaves.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto library_c< timeData_t >::mIntern( treePtr_t pTree ) ->treePtr_t {
+    if ( !pTree || !pTree->mcGetRoot() ) {
+        SMD_FBT_THROW( "Can't intern an empty tree." );
+    }
+
+    const uint64_t cHash { structuralHash( *pTree ) };
+    const auto     cRange = mInterned.equal_range( cHash );
+
+    for ( auto it = cRange.first; it != cRange.second; ++it ) {
+        if ( it->second->mcHasMemory() == pTree->mcHasMemory() && it->second->mcSharesGuards() == pTree->mcSharesGuards() &&
+             diffTrees( *it->second->mcGetRoot(), *pTree->mcGetRoot() ).empty() &&
+             mHaveSameFunctions( *it->second->mcGetRoot(), *pTree->mcGetRoot() ) ) {
+            return it->second;
+        }
+    }
+
+    return mInterned.emplace( cHash, move( pTree ) )->second;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool library_c< timeData_t >::mHaveSameFunctions( const node_t& cA, const node_t& cB ) noexcept {
+    switch ( cA.mcKind ) {
+        case nodeKind_t::ACTION:
+            return static_cast< const actionNode_c< timeData_t >& >( cA ).mcHasSameFunction(
+                static_cast< const actionNode_c< timeData_t >& >( cB ) );
+        case nodeKind_t::CONDITION:
+            return static_cast< const conditionNode_c< timeData_t >& >( cA ).mcHasSameFunction(
+                static_cast< const conditionNode_c< timeData_t >& >( cB ) );
+        case nodeKind_t::LAZY_SUBTREE:
+            return static_cast< const lazySubtreeNode_c< timeData_t >& >( cA ).mcHasSameFunction(
+                static_cast< const lazySubtreeNode_c< timeData_t >& >( cB ) );
+        default:
+            break;
+    }
+
+    for ( size_t iChild = 0; iChild < cA.mcGetNumChildren(); ++iChild ) {
+        if ( !mHaveSameFunctions( *cA.mcGetChild( iChild ), *cB.mcGetChild( iChild ) ) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto library_c< timeData_t >::mcGet( std::string_view cName ) const ->const treePtr_t& {
+    const auto cIt = mTrees.find( cName );
+
+    if ( cIt == mTrees.cend() ) {
+        SMD_FBT_THROW( "Can't find the behaviour in the library." );
+    }
+
+    return cIt->second;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool library_c< timeData_t >::mcHas( std::string_view cName ) const noexcept {
+    return mTrees.find( cName ) != mTrees.cend();
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t library_c< timeData_t >::mcGetNumTrees( void ) const noexcept {
+    return mTrees.size();
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t library_c< timeData_t >::mcGetNumInterned( void ) const noexcept {
+    return mInterned.size();
+}
+
+} // namespace smd::fbt
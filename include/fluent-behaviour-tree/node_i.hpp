@@ -26,33 +26,301 @@
 #pragma once
 
 #include "common.hpp"
+#include "profiler_c.hpp"
+#include "scratch_c.hpp"
 
 namespace smd::fbt {
 
+//==============================================================================================================================
+// Events are plain ids chosen by the user, see 'waitNode_c' and 'scheduler_c'.
+//==============================================================================================================================
+inline constexpr uint32_t cNoEvent { UINT32_MAX };
+
+//==============================================================================================================================
+template< typename timeData_t >
+class node_i;
+
+//==============================================================================================================================
+// Limits a time-sliced tick, see 'instance_c::mTick'. A visit is a sequence or selector moving on to its next child.
+//==============================================================================================================================
+struct tickBudget_t final {
+    uint32_t numVisits    { UINT32_MAX }; // Visits before the tick suspends.
+    int64_t  microseconds { 0 };          // Time before the tick suspends, zero for no limit.
+};
+
+//==============================================================================================================================
+// The budget left to a time-sliced tick, and where the tick suspended when it ran out. Composites that can't suspend (parallel,
+// reactive selector) tick their children without a slice.
+//==============================================================================================================================
+template< typename timeData_t >
+struct tickSlice_t final {
+    uint32_t                    numVisits;                        // Visits left.
+    int64_t                     deadline;                         // Of 'std::chrono::steady_clock' in ns, zero for none.
+    const node_i< timeData_t >* pSuspended { nullptr };           // Composite that suspended the tick.
+    uint32_t                    iDone      { 0 };                 // Child of 'pSuspended' ticked last.
+    status_t                    doneStatus { status_t::SUCCESS }; // Status 'iDone' returned.
+
+    inline bool mSuspend( const node_i< timeData_t >& cNode, uint32_t iChild, status_t childStatus ) noexcept;
+};
+
+//==============================================================================================================================
+// Starts the slice of a tick limited by 'cBudget'.
+//==============================================================================================================================
+template< typename timeData_t >
+inline tickSlice_t< timeData_t > startSlice( const tickBudget_t& cBudget ) noexcept {
+    const int64_t cNow { std::chrono::duration_cast< std::chrono::nanoseconds >(
+                             std::chrono::steady_clock::now().time_since_epoch() ).count() };
+
+    return { cBudget.numVisits, cBudget.microseconds > 0 ? cNow + cBudget.microseconds * 1000 : 0 };
+}
+
+//==============================================================================================================================
+// Everything a tick needs besides the tree itself. 'pState' points at the state block of the instance being ticked, a node
+// finds its own state at 'pState + mcGetStateOffset()'. The context is passed by reference from node to node, a large
+// 'timeData_t' is only referenced (see 'param_t') so it's never copied during a tick. Leaves taking the context allocate their
+// temporary buffers from 'pScratch', it's set by the root tick and the memory is reused once the root tick returns.
+//==============================================================================================================================
+template< typename timeData_t >
+struct tickContext_t final {
+    param_t< timeData_t >      timeData;               // Passed to the leaves.
+    uint8_t*                   pState;                 // Per-instance state of the tree being ticked.
+    profiler_c*                pProfiler { nullptr };  // Records the spans of the tick if set.
+    void*                      pAgent    { nullptr };  // Agent of the instance being ticked, for leaves taking the context.
+    uint32_t                   wakeEvent { cNoEvent }; // Event that woke the instance up for this tick, if any.
+    uint32_t                   waitEvent { cNoEvent }; // Set by a leaf that waits for an event, the instance may sleep until then.
+    tickSlice_t< timeData_t >* pSlice    { nullptr };  // Budget of a time-sliced tick, null for a whole tick.
+    uint64_t                   epoch     { 0 };        // Number of the tick for shared guards, zero if they aren't shared.
+    scratch_c*                 pScratch  { nullptr };  // Memory of the tick, the thread's scratch if the caller sets none.
+};
+
+//==============================================================================================================================
+// Called by a composite before it moves on to the child after 'iChild', which returned 'childStatus'. Returns true when the
+// budget has run out, then the composite returns RUNNING right away and a resumed tick continues by
+// 'cNode.mResume( context, iChild, childStatus )'.
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool tickSlice_t< timeData_t >::mSuspend( const node_i< timeData_t >& cNode, uint32_t iChild, status_t childStatus ) noexcept {
+    if ( numVisits > 0 && ( !deadline || std::chrono::duration_cast< std::chrono::nanoseconds >(
+                                             std::chrono::steady_clock::now().time_since_epoch() ).count() < deadline ) ) {
+        --numVisits;
+        return false;
+    }
+
+    pSuspended = &cNode;
+    iDone      = iChild;
+    doneStatus = childStatus;
+
+    return true;
+}
+
+//==============================================================================================================================
+// Every node can be traversed without knowing its concrete class: leaves just have no children. Traversal doesn't allocate
+// and doesn't call virtual functions. 'mcVisit' walks the nodes in pre-order, the visitor is called as
+// 'bool visitor( const node_i& cNode, uint32_t depth )' and returns whether to descend into the children of the node, e.g.
+// false for 'nodeKind_t::SUBTREE' to stay within the nodes of one tree.
 //==============================================================================================================================
 template< typename timeData_t >
 class node_i {
 public:
-    const std::string mcName; // Name of the node.
+    using context_t = tickContext_t< timeData_t >;
+
+    static constexpr uint32_t cStateAlign { 8 };          // Every node state starts at an offset aligned to it.
+    static constexpr uint32_t cNoChild    { UINT32_MAX }; // Index of no child.
+
+    const nodeKind_t  mcKind;      // Kind of the node, tells which concrete class it is.
+    const std::string mcName;      // Name of the node.
+    const uint32_t    mcStateSize; // Bytes of per-instance state the node needs, zero for stateless nodes.
+
+    virtual status_t mTick( context_t& context )                                        const noexcept = 0;
+    virtual status_t mResume( context_t& context, uint32_t iChild, status_t childStatus ) const noexcept;
+    virtual uint32_t mcGetResumeChild( const context_t& cContext )                       const noexcept;
+
+    template< typename visitor_tt >
+    inline void mVisit( visitor_tt&& visitor, uint32_t depth = 0 );
+    template< typename visitor_tt >
+    inline void mcVisit( visitor_tt&& visitor, uint32_t depth = 0 ) const;
+
+    inline const std::vector< node_i* >& mcGetChildren( void )       const noexcept; // Empty for leaves.
+    inline size_t                        mcGetNumChildren( void )    const noexcept;
+    inline node_i*                       mcGetChild( size_t iChild ) const noexcept;
 
-    virtual status_t mTick( timeData_t timeData ) = 0;
+    inline void mcResetState( context_t& context ) const noexcept; // Of the node and all its descendants.
+
+    inline bool     mcIsParent( void )                     const noexcept;
+    inline uint32_t mcGetId( void )                        const noexcept; // Unique within the tree, never reused.
+    inline void     mSetId( uint32_t id )                        noexcept;
+    inline uint32_t mcGetStateOffset( void )               const noexcept;
+    inline void     mSetStateOffset( uint32_t stateOffset )      noexcept;
 
     node_i&         operator=( const node_i& ) = delete;
     node_i&         operator=( node_i&& )      noexcept = delete;
-    explicit inline node_i( const std::string& cName );
+    inline          node_i( nodeKind_t kind, std::string_view cName, uint32_t stateSize = 0 );
     inline          node_i( const node_i& cNode );
-                    node_i( node_i&& )         noexcept = delete;
+    inline          node_i( node_i&& node );
     virtual         ~node_i( void )            = default;
+
+protected:
+    template< typename state_tt >
+    inline state_tt mcLoadState( const context_t& cContext )                   const noexcept;
+    template< typename state_tt >
+    inline void     mcStoreState( context_t& context, const state_tt& cState ) const noexcept;
+
+    std::vector< node_i* > mChildren; // Stays empty for leaves, filled by 'parentNode_i'.
+
+private:
+    uint32_t mId { 0 };          // Assigned by 'tree_c' in the order the nodes are created, e.g. by 'builder_c'.
+    uint32_t mStateOffset { 0 }; // Assigned by 'tree_c' when it lays out the state block.
 };
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline node_i< timeData_t >::node_i( const std::string& cName ) :
-    mcName( cName ) {}
+template< typename visitor_tt >
+inline void node_i< timeData_t >::mVisit( visitor_tt&& visitor, uint32_t depth ) {
+    if ( visitor( *this, depth ) ) {
+        for ( node_i* pChild : mChildren ) {
+            pChild->mVisit( visitor, depth + 1 );
+        }
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename visitor_tt >
+inline void node_i< timeData_t >::mcVisit( visitor_tt&& visitor, uint32_t depth ) const {
+    if ( visitor( *this, depth ) ) {
+        for ( const node_i* cpChild : mChildren ) {
+            cpChild->mcVisit( visitor, depth + 1 );
+        }
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto node_i< timeData_t >::mcGetChildren( void ) const noexcept ->const std::vector< node_i* >& {
+    return mChildren;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t node_i< timeData_t >::mcGetNumChildren( void ) const noexcept {
+    return mChildren.size();
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto node_i< timeData_t >::mcGetChild( size_t iChild ) const noexcept ->node_i* {
+    return mChildren[ iChild ];
+}
+
+//==============================================================================================================================
+// A sub-tree node's slot holds the whole state of its tree, so there is no need to descend into it.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void node_i< timeData_t >::mcResetState( context_t& context ) const noexcept {
+    mcVisit( [ &context ]( const node_i& cNode, uint32_t ) {
+        std::memset( context.pState + cNode.mStateOffset, 0, cNode.mcStateSize );
+        return cNode.mcKind != nodeKind_t::SUBTREE;
+    } );
+}
+
+//==============================================================================================================================
+// Continues a resumed tick (see 'activePath_c') after the child 'iChild' returned 'childStatus', as if the node had ticked its
+// children up to that one. Passes the status on by default, nodes with memory override it.
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t node_i< timeData_t >::mResume( context_t&, uint32_t, status_t childStatus ) const noexcept {
+    return childStatus;
+}
+
+//==============================================================================================================================
+// The child a resumed tick continues in, 'cNoChild' if no child is running or the node must tick all of its children again.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t node_i< timeData_t >::mcGetResumeChild( const context_t& ) const noexcept {
+    return cNoChild;
+}
+
+//==============================================================================================================================
+// Only action, condition, wait and lazy sub-tree nodes are leaves, all others derive from 'parentNode_i'.
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool node_i< timeData_t >::mcIsParent( void ) const noexcept {
+    return mcKind != nodeKind_t::ACTION && mcKind != nodeKind_t::CONDITION && mcKind != nodeKind_t::WAIT &&
+           mcKind != nodeKind_t::LAZY_SUBTREE;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t node_i< timeData_t >::mcGetId( void ) const noexcept {
+    return mId;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void node_i< timeData_t >::mSetId( uint32_t id ) noexcept {
+    mId = id;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t node_i< timeData_t >::mcGetStateOffset( void ) const noexcept {
+    return mStateOffset;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void node_i< timeData_t >::mSetStateOffset( uint32_t stateOffset ) noexcept {
+    mStateOffset = stateOffset;
+}
+
+//==============================================================================================================================
+// States are copied in and out by 'memcpy', it compiles to a plain load/store and doesn't break strict aliasing.
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename state_tt >
+inline state_tt node_i< timeData_t >::mcLoadState( const context_t& cContext ) const noexcept {
+    static_assert( std::is_trivially_copyable_v< state_tt > && alignof( state_tt ) <= cStateAlign );
+
+    state_tt state;
+    std::memcpy( &state, cContext.pState + mStateOffset, sizeof( state_tt ) );
+
+    return state;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename state_tt >
+inline void node_i< timeData_t >::mcStoreState( context_t& context, const state_tt& cState ) const noexcept {
+    static_assert( std::is_trivially_copyable_v< state_tt > && alignof( state_tt ) <= cStateAlign );
+
+    std::memcpy( context.pState + mStateOffset, &cState, sizeof( state_tt ) );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline node_i< timeData_t >::node_i( nodeKind_t kind, std::string_view cName, uint32_t stateSize ) :
+    mcKind( kind ),
+    mcName( cName ),
+    mcStateSize( stateSize ) {}
 
 //==============================================================================================================================
 template< typename timeData_t >
 inline node_i< timeData_t >::node_i( const node_i& cNode ) :
-    mcName( cNode.mcName ) {}
+    mcKind( cNode.mcKind ),
+    mcName( cNode.mcName ),
+    mcStateSize( cNode.mcStateSize ),
+    mChildren( cNode.mChildren ),
+    mId( cNode.mId ) {}
+
+//==============================================================================================================================
+// The name is constant so it's copied, it's short and doesn't allocate in most cases.
+//==============================================================================================================================
+template< typename timeData_t >
+inline node_i< timeData_t >::node_i( node_i&& node ) :
+    mcKind( node.mcKind ),
+    mcName( node.mcName ),
+    mcStateSize( node.mcStateSize ),
+    mChildren( std::move( node.mChildren ) ),
+    mId( node.mId ) {}
 
 } // namespace smd::fbt
@@ -0,0 +1,256 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "parentnode_i.hpp"
+#include "parallelnode_c.hpp"
+#include "tree_c.hpp"
+
+#include <unordered_map>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Removes redundant structure from a built tree without changing its behaviour:
+//   - an inverter of an inverter is replaced with the inner child;
+//   - a sequence/selector nested into a node of the same kind is flattened into its parent;
+//   - a sequence/selector with a single child is replaced with the child;
+//   - children that can never be reached are removed, e.g. children of a selector after a child that never fails.
+// Parent nodes are restructured in place. Spliced sub-trees are shared and immutable, so the pass doesn't descend into them.
+// Neither does it descend into reactive selectors, they resume their branches by the structure of the branches.
+// Nodes dropped from the structure are destroyed by the tree after the run, see 'tree_c::mDestroyDetached'. The builder doesn't
+// run the pass, it's a separate step after 'mBuild' so the caller can report the unreachable children.
+//==============================================================================================================================
+template< typename timeData_t >
+class optimizer_c final {
+    using node_t       = node_i< timeData_t >;
+    using parentNode_t = parentNode_i< timeData_t >;
+
+public:
+    static constexpr uint32_t cCanSucceed { 1 << static_cast< uint32_t >( status_t::SUCCESS ) };
+    static constexpr uint32_t cCanFail    { 1 << static_cast< uint32_t >( status_t::FAILURE ) };
+    static constexpr uint32_t cCanRun     { 1 << static_cast< uint32_t >( status_t::RUNNING ) };
+
+    inline void mRun( tree_c< timeData_t >& tree );
+
+    inline uint32_t                          mcGetOutcomes( const node_t& cNode ) const noexcept;
+    inline size_t                            mcGetNumRemoved( void )              const noexcept;
+    inline const std::vector< std::string >& mcGetUnreachable( void )             const noexcept;
+
+    optimizer_c& operator=( const optimizer_c& ) = delete;
+    optimizer_c& operator=( optimizer_c&& )      noexcept = delete;
+                 optimizer_c( void )             = default;
+                 optimizer_c( const optimizer_c& ) = delete;
+                 optimizer_c( optimizer_c&& )    noexcept = delete;
+                 ~optimizer_c( void )            = default;
+
+private:
+    std::unordered_map< const node_t*, uint32_t > mOutcomes;         // Statuses each visited node may return.
+    std::vector< std::string >                    mUnreachable;      // Names of removed unreachable children.
+    size_t                                        mNumRemoved { 0 }; // Number of nodes removed from the tree.
+
+    inline void     mOptimize( node_t*& pNode );
+    inline uint32_t mcComputeOutcomes( const node_t& cNode ) const noexcept;
+};
+
+//==============================================================================================================================
+// Runs the pass over a tree, the root of the tree changes if the root itself was collapsed. Nodes made by 'mCreate' and not
+// attached yet are destroyed along with the dropped ones.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void optimizer_c< timeData_t >::mRun( tree_c< timeData_t >& tree ) {
+    node_t* pRoot { tree.mGetRoot() };
+
+    if ( !pRoot ) {
+        SMD_FBT_THROW( "Can't optimize a behaviour tree with zero nodes" );
+    }
+
+    mOptimize( pRoot );
+    tree.mSetRoot( pRoot );
+
+    std::unordered_map< const node_t*, uint32_t > outcomes; // Of the nodes that stay, the dropped ones are destroyed.
+
+    pRoot->mcVisit( [ this, &outcomes ]( const node_t& cNode, uint32_t ) {
+        if ( const auto cIt = mOutcomes.find( &cNode ); cIt != mOutcomes.end() ) {
+            outcomes.emplace( *cIt );
+        }
+
+        return cNode.mcKind != nodeKind_t::SUBTREE;
+    } );
+
+    mOutcomes = move( outcomes );
+    tree.mDestroyDetached();
+}
+
+//==============================================================================================================================
+// Statuses the node may return as a set of 'cCan...' bits, the node must have been visited by the last run.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t optimizer_c< timeData_t >::mcGetOutcomes( const node_t& cNode ) const noexcept {
+    const auto cOutcomes = mOutcomes.find( &cNode );
+
+    return cOutcomes != mOutcomes.cend() ? cOutcomes->second : cCanSucceed | cCanFail | cCanRun;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t optimizer_c< timeData_t >::mcGetNumRemoved( void ) const noexcept {
+    return mNumRemoved;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto optimizer_c< timeData_t >::mcGetUnreachable( void ) const noexcept ->const std::vector< std::string >& {
+    return mUnreachable;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void optimizer_c< timeData_t >::mOptimize( node_t*& pNode ) {
+    const nodeKind_t cKind { pNode->mcKind };
+
+    if ( pNode->mcIsParent() && cKind != nodeKind_t::SUBTREE && cKind != nodeKind_t::REACTIVE_SELECTOR ) {
+        auto& parent = static_cast< parentNode_t& >( *pNode );
+
+        const bool cIsComposite { cKind == nodeKind_t::SEQUENCE || cKind == nodeKind_t::SELECTOR };
+
+        std::vector< node_t* > children;
+
+        for ( node_t* pChild : parent.mcGetChildren() ) {
+            mOptimize( pChild );
+
+            if ( cIsComposite && pChild->mcKind == cKind ) {
+                const auto& cGrandchildren = pChild->mcGetChildren();
+
+                children.insert( children.cend(), cGrandchildren.cbegin(), cGrandchildren.cend() );
+                ++mNumRemoved;
+
+            } else {
+                children.emplace_back( pChild );
+            }
+        }
+
+        if ( cIsComposite ) {
+            // A sequence goes to the next child only on success, a selector only on failure.
+            const uint32_t cContinue { cKind == nodeKind_t::SEQUENCE ? cCanSucceed : cCanFail };
+
+            for ( size_t iChild { 0 }; iChild + 1 < children.size(); ++iChild ) {
+                if ( !( mcGetOutcomes( *children[ iChild ] ) & cContinue ) ) {
+                    for ( size_t iUnreachable { iChild + 1 }; iUnreachable < children.size(); ++iUnreachable ) {
+                        mUnreachable.emplace_back( children[ iUnreachable ]->mcName );
+                    }
+
+                    mNumRemoved += children.size() - iChild - 1;
+                    children.resize( iChild + 1 );
+                    break;
+                }
+            }
+
+            if ( children.size() == 1 ) {
+                pNode = children.front();
+                ++mNumRemoved;
+                return;
+            }
+
+        } else if ( cKind == nodeKind_t::INVERTER && children.front()->mcKind == nodeKind_t::INVERTER ) {
+            pNode = children.front()->mcGetChild( 0 );
+            mNumRemoved += 2;
+            return;
+        }
+
+        parent.mSetChildren( move( children ) );
+    }
+
+    mOutcomes[ pNode ] = mcComputeOutcomes( *pNode );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t optimizer_c< timeData_t >::mcComputeOutcomes( const node_t& cNode ) const noexcept {
+    if ( cNode.mcKind == nodeKind_t::ACTION ) {
+        return cCanSucceed | cCanFail | cCanRun;
+    }
+    if ( cNode.mcKind == nodeKind_t::CONDITION ) {
+        return cCanSucceed | cCanFail;
+    }
+    if ( cNode.mcKind == nodeKind_t::WAIT ) {
+        return cCanSucceed | cCanRun;
+    }
+
+    const auto& cChildren = cNode.mcGetChildren();
+
+    switch ( cNode.mcKind ) {
+        case nodeKind_t::INVERTER: {
+            const uint32_t cChild { mcGetOutcomes( *cChildren.front() ) };
+
+            return ( cChild & cCanRun ) | ( cChild & cCanSucceed ? cCanFail : 0 ) | ( cChild & cCanFail ? cCanSucceed : 0 );
+        }
+        case nodeKind_t::SEQUENCE:
+        case nodeKind_t::SELECTOR:
+        case nodeKind_t::REACTIVE_SELECTOR: {
+            const uint32_t cContinue { cNode.mcKind == nodeKind_t::SEQUENCE ? cCanSucceed : cCanFail };
+
+            uint32_t outcomes { 0 };
+
+            for ( const auto& cpChild : cChildren ) {
+                const uint32_t cChild { mcGetOutcomes( *cpChild ) };
+
+                outcomes |= cChild & ~cContinue;
+
+                if ( !( cChild & cContinue ) ) {
+                    return outcomes;
+                }
+            }
+
+            return outcomes | cContinue;
+        }
+        case nodeKind_t::PARALLEL: {
+            const auto& cParallel = static_cast< const parallelNode_c< timeData_t >& >( cNode );
+
+            uint32_t numCanSucceed { 0 };
+            uint32_t numCanFail    { 0 };
+
+            for ( const auto& cpChild : cChildren ) {
+                const uint32_t cChild { mcGetOutcomes( *cpChild ) };
+
+                numCanSucceed += ( cChild & cCanSucceed ) != 0;
+                numCanFail    += ( cChild & cCanFail ) != 0;
+            }
+
+            const uint32_t cNumToSucceed { cParallel.mcGetNumToSucceed() };
+            const uint32_t cNumToFail    { cParallel.mcGetNumToFail() };
+
+            return cCanRun | ( cNumToSucceed > 0 && numCanSucceed >= cNumToSucceed ? cCanSucceed : 0 ) |
+                             ( cNumToFail > 0 && numCanFail >= cNumToFail ? cCanFail : 0 );
+        }
+        default:
+            return cCanSucceed | cCanFail | cCanRun;
+    }
+}
+
+} // namespace smd::fbt
@@ -37,34 +37,41 @@ namespace smd::fbt {
 template< typename timeData_t >
 class parallelNode_c final : public parentNode_i< timeData_t > {
     using parentNode_t = parentNode_i< timeData_t >;
-    using nodePtr_t    = std::shared_ptr< node_i< timeData_t > >;
+    using context_t    = typename parentNode_t::context_t;
 
 public:
-    inline status_t mTick( timeData_t time )      override;
-    inline void     mAddChild( nodePtr_t pChild ) override;
+    inline status_t mTick( context_t& context ) const noexcept override;
+
+    inline uint32_t mcGetNumToFail( void )    const noexcept;
+    inline uint32_t mcGetNumToSucceed( void ) const noexcept;
 
     parallelNode_c& operator=( const parallelNode_c& ) = delete;
     parallelNode_c& operator=( parallelNode_c&& )      noexcept = delete;
-    inline          parallelNode_c( const std::string& cName, uint32_t numToFail, uint32_t numToSucceed );
+    inline          parallelNode_c( std::string_view cName, uint32_t numToFail, uint32_t numToSucceed );
     inline          parallelNode_c( const parallelNode_c& cNode );
-                    parallelNode_c( parallelNode_c&& ) noexcept = delete;
+    inline          parallelNode_c( parallelNode_c&& node );
                     ~parallelNode_c( void )            = default;
 
 private:
     const uint32_t mcNumToFail;    // Number of child failures required to terminate with failure.
     const uint32_t mcNumToSucceed; // Number of child successess require to terminate with success.
 
-    std::vector< nodePtr_t > mChildren;
+    using parentNode_t::mChildren;
 };
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline status_t parallelNode_c< timeData_t >::mTick( timeData_t time ) {
+inline status_t parallelNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    const profileSpan_c cSpan( context.pProfiler, parentNode_t::mcName, "node" );
+
     uint32_t numChildrenSuceeded = 0;
     uint32_t numChildrenFailed = 0;
 
+    tickSlice_t< timeData_t >* const cpSlice { context.pSlice }; // All children are ticked every time, so they can't suspend.
+    context.pSlice = nullptr;
+
     for ( auto ipChild = mChildren.cbegin(); ipChild != mChildren.cend(); ++ipChild ) {
-        switch ( ( *ipChild )->mTick( time ) ) {
+        switch ( ( *ipChild )->mTick( context ) ) {
             case status_t::SUCCESS:
                 ++numChildrenSuceeded;
                 break;
@@ -76,6 +83,8 @@ inline status_t parallelNode_c< timeData_t >::mTick( timeData_t time ) {
         }
     }
 
+    context.pSlice = cpSlice;
+
     if ( mcNumToSucceed > 0 && numChildrenSuceeded >= mcNumToSucceed ) {
         return status_t::SUCCESS;
     }
@@ -88,14 +97,20 @@ inline status_t parallelNode_c< timeData_t >::mTick( timeData_t time ) {
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline void parallelNode_c< timeData_t >::mAddChild( nodePtr_t pChild ) {
-    mChildren.emplace_back( move( pChild ) );
+inline uint32_t parallelNode_c< timeData_t >::mcGetNumToFail( void ) const noexcept {
+    return mcNumToFail;
 }
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline parallelNode_c< timeData_t >::parallelNode_c( const std::string& cName, uint32_t numToFail, uint32_t numToSucceed ) :
-    parentNode_t( cName ),
+inline uint32_t parallelNode_c< timeData_t >::mcGetNumToSucceed( void ) const noexcept {
+    return mcNumToSucceed;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline parallelNode_c< timeData_t >::parallelNode_c( std::string_view cName, uint32_t numToFail, uint32_t numToSucceed ) :
+    parentNode_t( nodeKind_t::PARALLEL, cName, SIZE_MAX ),
     mcNumToFail( numToFail ),
     mcNumToSucceed( numToSucceed ) {}
 
@@ -104,7 +119,13 @@ template< typename timeData_t >
 inline parallelNode_c< timeData_t >::parallelNode_c( const parallelNode_c& cNode ) :
     parentNode_t( cNode ),
     mcNumToFail( cNode.mcNumToFail ),
-    mcNumToSucceed( cNode.mcNumToSucceed ),
-    mChildren( cNode.mChildren ) {}
+    mcNumToSucceed( cNode.mcNumToSucceed ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline parallelNode_c< timeData_t >::parallelNode_c( parallelNode_c&& node ) :
+    parentNode_t( std::move( node ) ),
+    mcNumToFail( node.mcNumToFail ),
+    mcNumToSucceed( node.mcNumToSucceed ) {}
 
 } // namespace smd::fbt
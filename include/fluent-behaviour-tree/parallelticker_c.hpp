@@ -0,0 +1,261 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "instance_c.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Ticks many instances on several threads without giving up determinism. Leaves don't change shared state while ticking,
+// they emit commands with 'mEmit' instead. Every thread ticks a contiguous range of agents in order and collects the commands
+// in its own buffer, the buffers are concatenated in thread order afterwards, so the commands always come in agent order no
+// matter how many threads ran. The trees must be shared by instances only, ticking a 'tree_c' directly isn't thread-safe.
+//
+// The worker threads are started with the ticker and live as long as it, a tick only wakes them up and waits for them.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+class parallelTicker_c final {
+    using instance_t = instance_c< timeData_t >;
+
+    template< typename, typename >
+    friend class partitionedTicker_c; // Shares the command buffers so the leaves emit the same way.
+
+public:
+    static inline void   mEmit( command_t command ); // Called by the leaves while 'mTick' runs.
+    static inline size_t mGetAgent( void ) noexcept; // Index of the agent being ticked by the calling thread.
+
+    inline const std::vector< command_t >& mTick( instance_t* pInstances, size_t numInstances, param_t< timeData_t > timeData );
+
+    inline const std::vector< command_t >& mcGetCommands( void )   const noexcept; // Commands of the last 'mTick'.
+    inline uint32_t                        mcGetNumThreads( void ) const noexcept;
+
+    parallelTicker_c& operator=( const parallelTicker_c& ) = delete;
+    parallelTicker_c& operator=( parallelTicker_c&& )      noexcept = default;
+    explicit inline   parallelTicker_c( uint32_t numThreads );
+                      parallelTicker_c( const parallelTicker_c& ) = delete;
+                      parallelTicker_c( parallelTicker_c&& )      noexcept = default;
+                      ~parallelTicker_c( void )                   = default;
+
+private:
+    struct alignas( 64 ) buffer_t final {
+        std::vector< command_t > commands;     // Kept between ticks so they don't allocate once warmed up.
+        size_t                   iAgent { 0 }; // Agent being ticked.
+    };
+
+    // Shared with the workers, it stays in place when the ticker is moved.
+    struct pool_t final {
+        std::vector< std::thread > workers;                 // Tick the ranges after the first one.
+        std::mutex                 mutex;                   // Guards the members below.
+        std::condition_variable    start;                   // Wakes the workers up for a tick.
+        std::condition_variable    done;                    // Signalled by the last worker done.
+        instance_t*                pInstances { nullptr };  // Of the tick in progress.
+        size_t                     numInstances { 0 };
+        const timeData_t*          cpTimeData { nullptr };
+        buffer_t*                  pBuffers { nullptr };
+        uint64_t                   generation { 0 };        // Number of ticks started.
+        uint32_t                   numThreads { 1 };        // Including the thread that calls 'mTick'.
+        uint32_t                   numBusy { 0 };           // Workers not done yet.
+        bool                       isStopping { false };
+
+        inline void mStart( uint32_t numAllThreads );
+        inline void mWork( uint32_t iThread ) noexcept;
+
+        inline ~pool_t( void ); // Stops and joins the workers started so far.
+    };
+
+    static inline void mTickRange( instance_t* pInstances, size_t iBegin, size_t iEnd, param_t< timeData_t > timeData,
+                                   buffer_t& buffer ) noexcept;
+
+    static inline thread_local buffer_t* mpThreadBuffer { nullptr }; // Buffer of the calling thread while it ticks.
+
+    uint32_t                  mNumThreads; // Including the thread that calls 'mTick'.
+    std::vector< buffer_t >   mBuffers;    // One per thread.
+    std::vector< command_t >  mCommands;   // Commands of all threads in agent order.
+    std::unique_ptr< pool_t > mpPool;
+};
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void parallelTicker_c< timeData_t, command_t >::mEmit( command_t command ) {
+    if ( !mpThreadBuffer ) {
+        SMD_FBT_THROW( "Can't emit a command outside of 'parallelTicker_c::mTick'." );
+    }
+
+    mpThreadBuffer->commands.emplace_back( std::move( command ) );
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline size_t parallelTicker_c< timeData_t, command_t >::mGetAgent( void ) noexcept {
+    return mpThreadBuffer ? mpThreadBuffer->iAgent : SIZE_MAX;
+}
+
+//==============================================================================================================================
+// The calling thread ticks the first range itself while the workers tick the others.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline auto parallelTicker_c< timeData_t, command_t >::mTick( instance_t* pInstances, size_t numInstances,
+                                                            param_t< timeData_t > timeData ) ->const std::vector< command_t >& {
+    const size_t cRange { ( numInstances + mNumThreads - 1 ) / mNumThreads };
+
+    if ( mNumThreads > 1 ) {
+        {
+            const std::lock_guard< std::mutex > cLock( mpPool->mutex );
+
+            mpPool->pInstances   = pInstances;
+            mpPool->numInstances = numInstances;
+            mpPool->cpTimeData   = &timeData;
+            mpPool->pBuffers     = mBuffers.data();
+            mpPool->numBusy      = mNumThreads - 1;
+            ++mpPool->generation;
+        }
+        mpPool->start.notify_all();
+    }
+
+    mTickRange( pInstances, 0, std::min( numInstances, cRange ), timeData, mBuffers.front() );
+
+    if ( mNumThreads > 1 ) {
+        std::unique_lock< std::mutex > lock( mpPool->mutex );
+        mpPool->done.wait( lock, [ this ]{ return mpPool->numBusy == 0; } );
+    }
+
+    mCommands.clear();
+    for ( auto& buffer : mBuffers ) {
+        mCommands.insert( mCommands.end(), std::make_move_iterator( buffer.commands.begin() ),
+                          std::make_move_iterator( buffer.commands.end() ) );
+    }
+
+    return mCommands;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline auto parallelTicker_c< timeData_t, command_t >::mcGetCommands( void ) const noexcept ->const std::vector< command_t >& {
+    return mCommands;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline uint32_t parallelTicker_c< timeData_t, command_t >::mcGetNumThreads( void ) const noexcept {
+    return mNumThreads;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline parallelTicker_c< timeData_t, command_t >::parallelTicker_c( uint32_t numThreads ) :
+    mNumThreads( numThreads ),
+    mBuffers( numThreads ),
+    mpPool( std::make_unique< pool_t >() ) {
+    if ( numThreads == 0 ) {
+        SMD_FBT_THROW( "Can't tick on zero threads." );
+    }
+
+    mpPool->mStart( numThreads );
+}
+
+//==============================================================================================================================
+// If starting a worker throws, the pool is destroyed with the ticker and joins the workers started before.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void parallelTicker_c< timeData_t, command_t >::pool_t::mStart( uint32_t numAllThreads ) {
+    numThreads = numAllThreads;
+    workers.reserve( numThreads - 1 );
+
+    for ( uint32_t iThread = 1; iThread < numThreads; ++iThread ) {
+        workers.emplace_back( &pool_t::mWork, this, iThread );
+    }
+}
+
+//==============================================================================================================================
+// Ticks the range of the worker every time the generation changes. The range is computed as in 'mTick'.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void parallelTicker_c< timeData_t, command_t >::pool_t::mWork( uint32_t iThread ) noexcept {
+    uint64_t seen { 0 };
+
+    for ( ;; ) {
+        {
+            std::unique_lock< std::mutex > lock( mutex );
+            start.wait( lock, [ & ]{ return isStopping || generation != seen; } );
+
+            if ( isStopping ) {
+                return;
+            }
+
+            seen = generation;
+        }
+
+        const size_t cRange { ( numInstances + numThreads - 1 ) / numThreads };
+        const size_t cBegin { std::min( numInstances, iThread * cRange ) };
+        const size_t cEnd { std::min( numInstances, cBegin + cRange ) };
+
+        mTickRange( pInstances, cBegin, cEnd, *cpTimeData, pBuffers[ iThread ] );
+
+        const std::lock_guard< std::mutex > cLock( mutex );
+
+        if ( --numBusy == 0 ) {
+            done.notify_one();
+        }
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline parallelTicker_c< timeData_t, command_t >::pool_t::~pool_t( void ) {
+    {
+        const std::lock_guard< std::mutex > cLock( mutex );
+
+        isStopping = true;
+    }
+    start.notify_all();
+
+    for ( auto& worker : workers ) {
+        worker.join();
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void parallelTicker_c< timeData_t, command_t >::mTickRange( instance_t* pInstances, size_t iBegin, size_t iEnd,
+                                                                   param_t< timeData_t > timeData, buffer_t& buffer ) noexcept {
+    buffer.commands.clear();
+    mpThreadBuffer = &buffer;
+
+    for ( size_t iAgent = iBegin; iAgent < iEnd; ++iAgent ) {
+        buffer.iAgent = iAgent;
+        pInstances[ iAgent ].mTick( timeData );
+    }
+
+    mpThreadBuffer = nullptr;
+}
+
+} // namespace smd::fbt
@@ -30,30 +30,134 @@
 
 namespace smd::fbt {
 
+//==============================================================================================================================
+// Children are referenced by plain pointers, nodes are owned by their 'tree_c'. The children are stored by 'node_i' so any
+// node can be traversed, this interface adds the means to change them.
 //==============================================================================================================================
 template< typename timeData_t >
 class parentNode_i : public node_i< timeData_t > {
     using node_t = node_i< timeData_t >;
 
 public:
-    virtual void mAddChild( std::shared_ptr< node_t > pChild ) = 0;
+    inline void    mAddChild( node_t* pChild );
+    inline void    mSetChildren( std::vector< node_t* > children );
+    inline void    mInsertChild( size_t iChild, node_t* pChild );
+    inline node_t* mRemoveChild( size_t iChild );                  // Returns the removed child.
+    inline node_t* mReplaceChild( size_t iChild, node_t* pChild ); // Returns the replaced child.
+
+    inline bool mcIsComplete( void ) const noexcept; // Has all children required to tick.
+    inline bool mcIsFull( void )     const noexcept; // Can't have more children.
 
     parentNode_i&   operator=( const parentNode_i& ) = delete;
     parentNode_i&   operator=( parentNode_i&& )      noexcept = delete;
-    explicit inline parentNode_i( const std::string& cName );
+    inline          parentNode_i( nodeKind_t kind, std::string_view cName, size_t maxChildren, uint32_t stateSize = 0 );
     inline          parentNode_i( const parentNode_i& cNode );
-                    parentNode_i( parentNode_i&& )   noexcept = delete;
+    inline          parentNode_i( parentNode_i&& node );
     virtual         ~parentNode_i( void )            = default;
+
+protected:
+    const size_t mcMaxChildren; // Arity of the node.
+
+    using node_t::mChildren;
 };
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline parentNode_i< timeData_t >::parentNode_i( const std::string& cName ) :
-    node_t( cName ) {}
+inline void parentNode_i< timeData_t >::mAddChild( node_t* pChild ) {
+    if ( !pChild ) {
+        SMD_FBT_THROW( "Can't add an empty child." );
+    }
+    if ( mChildren.size() >= mcMaxChildren ) {
+        SMD_FBT_THROW( "Can't add more children than the node can have, e.g. more than a single child to 'inverterNode_c'!" );
+    }
+
+    mChildren.emplace_back( pChild );
+}
+
+//==============================================================================================================================
+// Replaces all children at once, used by the passes that restructure a built tree.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void parentNode_i< timeData_t >::mSetChildren( std::vector< node_t* > children ) {
+    if ( children.empty() || children.size() > mcMaxChildren ) {
+        SMD_FBT_THROW( "Can't set a number of children the node can't have." );
+    }
+
+    mChildren = move( children );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void parentNode_i< timeData_t >::mInsertChild( size_t iChild, node_t* pChild ) {
+    if ( iChild > mChildren.size() ) {
+        SMD_FBT_THROW( "Can't insert a child past the end of the children." );
+    }
+
+    mAddChild( pChild );
+    std::rotate( mChildren.begin() + iChild, mChildren.end() - 1, mChildren.end() );
+}
+
+//==============================================================================================================================
+// The node must keep at least one child, replace the last child instead of removing it.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto parentNode_i< timeData_t >::mRemoveChild( size_t iChild ) ->node_t* {
+    if ( iChild >= mChildren.size() ) {
+        SMD_FBT_THROW( "Can't remove a child that doesn't exist." );
+    }
+    if ( mChildren.size() == 1 ) {
+        SMD_FBT_THROW( "Can't remove the last child, the node couldn't tick without children." );
+    }
+
+    node_t* const cpChild { mChildren[ iChild ] };
+    mChildren.erase( mChildren.begin() + iChild );
+
+    return cpChild;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto parentNode_i< timeData_t >::mReplaceChild( size_t iChild, node_t* pChild ) ->node_t* {
+    if ( iChild >= mChildren.size() ) {
+        SMD_FBT_THROW( "Can't replace a child that doesn't exist." );
+    }
+    if ( !pChild ) {
+        SMD_FBT_THROW( "Can't replace a child with an empty one." );
+    }
+
+    return std::exchange( mChildren[ iChild ], pChild );
+}
+
+//==============================================================================================================================
+// Every parent node needs at least one child: an inverter has nothing to invert and an empty composite is a design mistake.
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool parentNode_i< timeData_t >::mcIsComplete( void ) const noexcept {
+    return !mChildren.empty();
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool parentNode_i< timeData_t >::mcIsFull( void ) const noexcept {
+    return mChildren.size() >= mcMaxChildren;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline parentNode_i< timeData_t >::parentNode_i( nodeKind_t kind, std::string_view cName, size_t maxChildren, uint32_t stateSize ) :
+    node_t( kind, cName, stateSize ),
+    mcMaxChildren( maxChildren ) {}
 
 //==============================================================================================================================
 template< typename timeData_t >
 inline parentNode_i< timeData_t >::parentNode_i( const parentNode_i& cNode ) :
-    node_t( cNode ) {}
+    node_t( cNode ),
+    mcMaxChildren( cNode.mcMaxChildren ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline parentNode_i< timeData_t >::parentNode_i( parentNode_i&& node ) :
+    node_t( std::move( node ) ),
+    mcMaxChildren( node.mcMaxChildren ) {}
 
 } // namespace smd::fbt
@@ -0,0 +1,456 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "arena_c.hpp"
+#include "common.hpp"
+#include "instance_c.hpp"
+#include "parallelticker_c.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// A runtime for large populations that keeps the data of every thread local. The agents are dealt round-robin to partitions,
+// each partition is ticked by a worker thread of its own that lives as long as the ticker and is pinned to a core. The worker
+// places the instances of its partition and their state in its own arena, so the memory is first touched by the core that
+// ticks it and stays on its NUMA node, and no cache line is shared with another partition. Pass the cores explicitly to choose
+// the nodes, e.g. one partition per core of each node. State blocks regrown after edits of the trees leave their old blocks
+// behind, once those make up a quarter of an arena the worker rebuilds its partition in a fresh arena and frees the old one.
+//
+// Leaves emit commands with 'parallelTicker_c::mEmit' as with the parallel ticker, so the same trees run on both, and the
+// commands come in agent order however many partitions there are. Pinning is best effort, see 'mcIsPinned'.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+class partitionedTicker_c final {
+    using tree_t    = tree_c< timeData_t >;
+    using treePtr_t = std::shared_ptr< const tree_t >;
+    using ticker_t  = parallelTicker_c< timeData_t, command_t >;
+    using buffer_t  = typename ticker_t::buffer_t;
+
+public:
+    using instance_t = instance_c< timeData_t, arenaAllocator_c< stateWord_t > >;
+
+    inline size_t                          mAdd( treePtr_t pTree, void* pAgent = nullptr ); // Returns the index of the agent.
+    inline const std::vector< command_t >& mTick( param_t< timeData_t > timeData );
+
+    inline const std::vector< command_t >& mcGetCommands( void )                     const noexcept; // Of the last 'mTick'.
+    inline const instance_t*               mcGetInstance( size_t iAgent )            const noexcept; // Null until ticked.
+    inline size_t                          mcGetNumAgents( void )                    const noexcept;
+    inline uint32_t                        mcGetNumPartitions( void )                const noexcept;
+    inline bool                            mcIsPinned( uint32_t iPartition )         const noexcept;
+    inline size_t                          mcGetNumArenaBytes( uint32_t iPartition ) const noexcept;
+
+    partitionedTicker_c& operator=( const partitionedTicker_c& ) = delete;
+    partitionedTicker_c& operator=( partitionedTicker_c&& )      = delete;
+    explicit inline      partitionedTicker_c( uint32_t numPartitions );                // On cores 0, 1, 2 and so on.
+    explicit inline      partitionedTicker_c( const std::vector< uint32_t >& cCores ); // One partition per core.
+                         partitionedTicker_c( const partitionedTicker_c& ) = delete;
+                         partitionedTicker_c( partitionedTicker_c&& )      = delete;
+    inline               ~partitionedTicker_c( void );
+
+private:
+    struct added_t final {
+        treePtr_t pTree;
+        void*     pAgent;
+    };
+
+    // Everything of a partition the worker places in its arena, rebuilt together.
+    struct placed_t final {
+        arena_c                                                     arena;       // Destroyed after the vectors below.
+        std::vector< instance_t*, arenaAllocator_c< instance_t* > > instances;   // In agent order.
+        std::vector< size_t, arenaAllocator_c< size_t > >           commandEnds; // End of the commands of every instance.
+
+        inline placed_t( void );
+        inline ~placed_t( void );
+    };
+
+    struct alignas( 64 ) partition_t final {
+        std::unique_ptr< placed_t > pPlaced;            // Instances of the partition and their state.
+        std::vector< added_t >      added;              // Added since the last tick, placed by the worker.
+        buffer_t                    buffer;             // Commands of the last tick.
+        uint32_t                    iPartition { 0 };
+        uint32_t                    core { 0 };
+        bool                        isPinned { false };
+    };
+
+    static inline bool mPin( uint32_t core ) noexcept;
+    static inline void mRebuild( partition_t& partition );
+
+    inline void mWork( partition_t& partition ) noexcept;
+    inline void mTickPartition( partition_t& partition ) noexcept;
+    inline void mFinishWork( void ) noexcept;
+    inline void mStop( void ) noexcept;
+
+    std::vector< partition_t > mPartitions;
+    std::vector< std::thread > mWorkers;                 // One per partition.
+    std::vector< command_t >   mCommands;                // Commands of all partitions in agent order.
+    size_t                     mNumAgents { 0 };
+    std::mutex                 mMutex;                   // Guards the members below.
+    std::condition_variable    mStart;                   // Wakes the workers up for a tick.
+    std::condition_variable    mDone;                    // Signalled by the last worker done.
+    const timeData_t*          mcpTimeData { nullptr };  // Of the tick in progress.
+    uint64_t                   mGeneration { 0 };        // Number of ticks started.
+    uint32_t                   mNumBusy { 0 };           // Workers not done yet.
+    bool                       mIsStopping { false };
+};
+
+//==============================================================================================================================
+// The instance is placed by the worker at the start of the next tick, so its memory is local to the worker.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline size_t partitionedTicker_c< timeData_t, command_t >::mAdd( treePtr_t pTree, void* pAgent ) {
+    if ( !pTree || !pTree->mcGetRoot() ) {
+        SMD_FBT_THROW( "Can't create an instance of an empty tree." );
+    }
+
+    const size_t cAgent { mNumAgents++ };
+
+    mPartitions[ cAgent % mPartitions.size() ].added.emplace_back( added_t { move( pTree ), pAgent } );
+
+    return cAgent;
+}
+
+//==============================================================================================================================
+// All partitions are ticked by their workers while the calling thread waits, then their commands are merged agent by agent.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline auto partitionedTicker_c< timeData_t, command_t >::mTick( param_t< timeData_t > timeData )
+    ->const std::vector< command_t >& {
+    {
+        const std::lock_guard< std::mutex > cLock( mMutex );
+
+        mcpTimeData = &timeData;
+        mNumBusy    = static_cast< uint32_t >( mPartitions.size() );
+        ++mGeneration;
+    }
+    mStart.notify_all();
+
+    {
+        std::unique_lock< std::mutex > lock( mMutex );
+        mDone.wait( lock, [ this ]{ return mNumBusy == 0; } );
+    }
+
+    mCommands.clear();
+    for ( size_t iAgent = 0; iAgent < mNumAgents; ++iAgent ) {
+        partition_t& partition { mPartitions[ iAgent % mPartitions.size() ] };
+        const size_t cLocal { iAgent / mPartitions.size() };
+        const auto   cBegin { partition.buffer.commands.begin() };
+
+        const auto&  cEnds { partition.pPlaced->commandEnds };
+
+        if ( cLocal >= cEnds.size() ) {
+            continue; // Not placed yet.
+        }
+
+        mCommands.insert( mCommands.end(), std::make_move_iterator( cBegin + ( cLocal > 0 ? cEnds[ cLocal - 1 ] : 0 ) ),
+                          std::make_move_iterator( cBegin + cEnds[ cLocal ] ) );
+    }
+
+    return mCommands;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline auto partitionedTicker_c< timeData_t, command_t >::mcGetCommands( void ) const noexcept ->const std::vector< command_t >& {
+    return mCommands;
+}
+
+//==============================================================================================================================
+// A tick may rebuild the partition of the agent in a fresh arena, so the pointer is valid until the next tick.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline auto partitionedTicker_c< timeData_t, command_t >::mcGetInstance( size_t iAgent ) const noexcept ->const instance_t* {
+    if ( iAgent >= mNumAgents ) {
+        return nullptr;
+    }
+
+    const partition_t& cPartition { mPartitions[ iAgent % mPartitions.size() ] };
+    const size_t       cLocal { iAgent / mPartitions.size() };
+    const auto&        cInstances { cPartition.pPlaced->instances };
+
+    return cLocal < cInstances.size() ? cInstances[ cLocal ] : nullptr;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline size_t partitionedTicker_c< timeData_t, command_t >::mcGetNumAgents( void ) const noexcept {
+    return mNumAgents;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline uint32_t partitionedTicker_c< timeData_t, command_t >::mcGetNumPartitions( void ) const noexcept {
+    return static_cast< uint32_t >( mPartitions.size() );
+}
+
+//==============================================================================================================================
+// Pinning fails where the core isn't available to the process, the partition is ticked on an unpinned worker then.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline bool partitionedTicker_c< timeData_t, command_t >::mcIsPinned( uint32_t iPartition ) const noexcept {
+    return mPartitions[ iPartition ].isPinned;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline size_t partitionedTicker_c< timeData_t, command_t >::mcGetNumArenaBytes( uint32_t iPartition ) const noexcept {
+    return mPartitions[ iPartition ].pPlaced->arena.mcGetNumBytes();
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline partitionedTicker_c< timeData_t, command_t >::partitionedTicker_c( uint32_t numPartitions ) :
+    partitionedTicker_c( [ numPartitions ]{
+        const uint32_t cNumCores { std::max( 1u, std::thread::hardware_concurrency() ) };
+
+        std::vector< uint32_t > cores( numPartitions );
+        for ( uint32_t iPartition = 0; iPartition < numPartitions; ++iPartition ) {
+            cores[ iPartition ] = iPartition % cNumCores;
+        }
+
+        return cores;
+    }() ) {
+}
+
+//==============================================================================================================================
+// Returns once every worker has pinned itself. If starting a worker throws, the workers started before are stopped and joined
+// before the exception leaves, the destructor doesn't run for a ticker not constructed.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline partitionedTicker_c< timeData_t, command_t >::partitionedTicker_c( const std::vector< uint32_t >& cCores ) :
+    mPartitions( cCores.size() ) {
+    if ( cCores.empty() ) {
+        SMD_FBT_THROW( "Can't tick on zero partitions." );
+    }
+
+    struct stopGuard_t final {
+        partitionedTicker_c* pTicker; // Null once all workers started.
+
+        ~stopGuard_t( void ) {
+            if ( pTicker ) {
+                pTicker->mStop();
+            }
+        }
+    } stopGuard { this };
+
+    mNumBusy = static_cast< uint32_t >( cCores.size() );
+
+    for ( size_t iPartition = 0; iPartition < cCores.size(); ++iPartition ) {
+        mPartitions[ iPartition ].pPlaced    = std::make_unique< placed_t >();
+        mPartitions[ iPartition ].iPartition = static_cast< uint32_t >( iPartition );
+        mPartitions[ iPartition ].core       = cCores[ iPartition ];
+    }
+
+    mWorkers.reserve( cCores.size() );
+    for ( partition_t& partition : mPartitions ) {
+        mWorkers.emplace_back( &partitionedTicker_c::mWork, this, std::ref( partition ) );
+    }
+
+    stopGuard.pTicker = nullptr;
+
+    std::unique_lock< std::mutex > lock( mMutex );
+    mDone.wait( lock, [ this ]{ return mNumBusy == 0; } );
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline partitionedTicker_c< timeData_t, command_t >::~partitionedTicker_c( void ) {
+    mStop();
+}
+
+//==============================================================================================================================
+// The vectors allocate from the arena too, so they are placed by the worker like the instances.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline partitionedTicker_c< timeData_t, command_t >::placed_t::placed_t( void ) :
+    instances( arenaAllocator_c< instance_t* >( arena ) ),
+    commandEnds( arenaAllocator_c< size_t >( arena ) ) {
+}
+
+//==============================================================================================================================
+// The instances live in the arena, only their destructors are run, the arena frees the memory afterwards.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline partitionedTicker_c< timeData_t, command_t >::placed_t::~placed_t( void ) {
+    for ( instance_t* pInstance : instances ) {
+        pInstance->~instance_t();
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline bool partitionedTicker_c< timeData_t, command_t >::mPin( uint32_t core ) noexcept {
+#ifdef __linux__
+    if ( core >= CPU_SETSIZE ) {
+        return false;
+    }
+
+    cpu_set_t cores;
+    CPU_ZERO( &cores );
+    CPU_SET( core, &cores );
+
+    return pthread_setaffinity_np( pthread_self(), sizeof( cores ), &cores ) == 0;
+#else
+    static_cast< void >( core );
+
+    return false;
+#endif
+}
+
+//==============================================================================================================================
+// Copies the instances of a partition into a fresh arena, the old arena is freed with everything released in it. If an
+// allocation throws the partition stays in the old arena.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void partitionedTicker_c< timeData_t, command_t >::mRebuild( partition_t& partition ) {
+    auto pPlaced = std::make_unique< placed_t >();
+
+    pPlaced->instances.reserve( partition.pPlaced->instances.size() );
+    pPlaced->commandEnds.reserve( partition.pPlaced->instances.size() );
+    for ( const instance_t* cpInstance : partition.pPlaced->instances ) {
+        void* const cpMemory { pPlaced->arena.mAllocate( sizeof( instance_t ) ) };
+
+        pPlaced->instances.emplace_back(
+            new ( cpMemory ) instance_t( *cpInstance, arenaAllocator_c< stateWord_t >( pPlaced->arena ) ) );
+    }
+
+    partition.pPlaced = move( pPlaced );
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void partitionedTicker_c< timeData_t, command_t >::mWork( partition_t& partition ) noexcept {
+    partition.isPinned = mPin( partition.core );
+    mFinishWork();
+
+    uint64_t generation { 0 };
+
+    for ( ;; ) {
+        {
+            std::unique_lock< std::mutex > lock( mMutex );
+            mStart.wait( lock, [ & ]{ return mIsStopping || mGeneration != generation; } );
+
+            if ( mIsStopping ) {
+                return;
+            }
+
+            generation = mGeneration;
+        }
+
+        mTickPartition( partition );
+        mFinishWork();
+    }
+}
+
+//==============================================================================================================================
+// Places the instances added since the last tick in the arena first, then ticks them all in agent order. The worker can't
+// throw, so when the arena runs out of memory the rebuild is put off and the agents that couldn't be placed wait for a later
+// tick in agent order, they emit no commands meanwhile. 'commandEnds' has room for every placed instance before it's placed,
+// so the tick itself doesn't allocate from the arena.
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void partitionedTicker_c< timeData_t, command_t >::mTickPartition( partition_t& partition ) noexcept {
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    try {
+#endif
+    if ( partition.pPlaced->arena.mcGetNumReleasedBytes() * 4 > partition.pPlaced->arena.mcGetNumBytes() ) {
+        mRebuild( partition );
+    }
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    } catch ( ... ) { }
+#endif
+
+    placed_t& placed { *partition.pPlaced };
+    size_t    numPlaced { 0 };
+
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    try {
+#endif
+    placed.commandEnds.reserve( placed.instances.size() + partition.added.size() );
+    placed.instances.reserve( placed.instances.size() + partition.added.size() );
+
+    for ( added_t& added : partition.added ) {
+        void* const cpMemory { placed.arena.mAllocate( sizeof( instance_t ) ) };
+        instance_t* const cpInstance {
+            new ( cpMemory ) instance_t( added.pTree, arenaAllocator_c< stateWord_t >( placed.arena ) ) };
+
+        cpInstance->mSetAgent( added.pAgent );
+        placed.instances.emplace_back( cpInstance );
+        ++numPlaced;
+    }
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    } catch ( ... ) { }
+#endif
+    partition.added.erase( partition.added.begin(), partition.added.begin() + numPlaced );
+
+    partition.buffer.commands.clear();
+    placed.commandEnds.clear();
+    ticker_t::mpThreadBuffer = &partition.buffer;
+
+    for ( size_t iLocal = 0; iLocal < placed.instances.size(); ++iLocal ) {
+        partition.buffer.iAgent = iLocal * mPartitions.size() + partition.iPartition;
+        placed.instances[ iLocal ]->mTick( *mcpTimeData );
+        placed.commandEnds.emplace_back( partition.buffer.commands.size() );
+    }
+
+    ticker_t::mpThreadBuffer = nullptr;
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void partitionedTicker_c< timeData_t, command_t >::mFinishWork( void ) noexcept {
+    const std::lock_guard< std::mutex > cLock( mMutex );
+
+    if ( --mNumBusy == 0 ) {
+        mDone.notify_one();
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t, typename command_t >
+inline void partitionedTicker_c< timeData_t, command_t >::mStop( void ) noexcept {
+    {
+        const std::lock_guard< std::mutex > cLock( mMutex );
+
+        mIsStopping = true;
+    }
+    mStart.notify_all();
+
+    for ( auto& worker : mWorkers ) {
+        worker.join();
+    }
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,263 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Captures tick spans of trees and composite nodes into a ring of fixed capacity, the oldest spans are overwritten once it's
+// full, so the memory is bounded however long it runs. Pass it to 'tree_c::mTick' or 'instance_c::mTick' to profile the tick,
+// switch it off and on at runtime with 'mSetEnabled'. The profiler copies every name into a table of its own while a span in
+// the ring refers to it, so the spans stay valid after the trees are edited, released or destroyed, and the table is bounded
+// by the ring as well. Not thread-safe, use one profiler per thread, every span records the thread it was recorded on.
+//==============================================================================================================================
+class profiler_c final {
+public:
+    struct span_t final {
+        const std::string* pName;     // Name of the tree or node, owned by the profiler.
+        const char*        pCategory; // "tree" or "node".
+        int64_t            begin;     // Nanoseconds since the profiler was created.
+        int64_t            end;
+        uint32_t           threadId;  // See 'mGetThreadId'.
+    };
+
+    inline void mSetEnabled( bool isEnabled ) noexcept;
+    inline void mClear( void )                noexcept;
+    inline void mRecord( const std::string& cName, const char* cpCategory, int64_t begin, int64_t end ) noexcept;
+
+    inline bool          mcIsEnabled( void )                        const noexcept;
+    inline int64_t       mcNow( void )                              const noexcept;
+    inline size_t        mcGetNumSpans( void )                      const noexcept;
+    inline size_t        mcGetNumNames( void )                      const noexcept; // Referred to by the spans.
+    inline const span_t& mcGetSpan( size_t iSpan )                  const noexcept; // The oldest span first.
+    inline void          mcWriteChromeTrace( std::ostream& stream ) const;          // Trace-event JSON, e.g. for Perfetto.
+
+    profiler_c&     operator=( const profiler_c& ) = delete;
+    profiler_c&     operator=( profiler_c&& )      noexcept = default;
+    explicit inline profiler_c( size_t capacity );
+                    profiler_c( const profiler_c& ) = delete;
+                    profiler_c( profiler_c&& )      noexcept = default;
+                    ~profiler_c( void )             = default;
+
+    static inline uint32_t mGetThreadId( void ) noexcept; // Small and stable for the life of the calling thread.
+
+private:
+    inline const std::string* mIntern( const std::string& cName ) noexcept; // Or null if out of memory.
+    inline void               mRelease( const std::string* cpName ) noexcept;
+
+    std::chrono::steady_clock::time_point     mStart;              // Zero of the time line.
+    std::vector< span_t >                     mSpans;              // Ring of spans.
+    size_t                                    mNext { 0 };         // Where the next span goes.
+    size_t                                    mNumSpans { 0 };     // Up to the capacity.
+    bool                                      mIsEnabled { true }; // Spans are recorded only when enabled.
+    std::unordered_map< std::string, size_t > mNames;              // Numbers of spans in the ring by name, keys never move.
+};
+
+//==============================================================================================================================
+// Records a span from its construction to its destruction, does nothing but a branch when there is no enabled profiler.
+//==============================================================================================================================
+class profileSpan_c final {
+public:
+    profileSpan_c&  operator=( const profileSpan_c& ) = delete;
+    profileSpan_c&  operator=( profileSpan_c&& )      noexcept = delete;
+    inline          profileSpan_c( profiler_c* pProfiler, const std::string& cName, const char* cpCategory ) noexcept;
+                    profileSpan_c( const profileSpan_c& ) = delete;
+                    profileSpan_c( profileSpan_c&& )      noexcept = delete;
+    inline          ~profileSpan_c( void )                noexcept;
+
+private:
+    profiler_c* const  mcpProfiler; // Or null when not profiling.
+    const std::string& mcName;
+    const char* const  mcpCategory;
+    int64_t            mBegin { 0 };
+};
+
+//==============================================================================================================================
+inline void profiler_c::mSetEnabled( bool isEnabled ) noexcept {
+    mIsEnabled = isEnabled;
+}
+
+//==============================================================================================================================
+inline void profiler_c::mClear( void ) noexcept {
+    mNext     = 0;
+    mNumSpans = 0;
+    mNames.clear();
+}
+
+//==============================================================================================================================
+// A span whose name can't be copied for lack of memory is dropped. The span overwritten in a full ring releases its name.
+//==============================================================================================================================
+inline void profiler_c::mRecord( const std::string& cName, const char* cpCategory, int64_t begin, int64_t end ) noexcept {
+    const std::string* const cpName { mIntern( cName ) };
+
+    if ( !cpName ) {
+        return;
+    }
+
+    if ( mNumSpans == mSpans.size() ) {
+        mRelease( mSpans[ mNext ].pName );
+    }
+
+    mSpans[ mNext ] = span_t { cpName, cpCategory, begin, end, mGetThreadId() };
+    mNext           = mNext + 1 == mSpans.size() ? 0 : mNext + 1;
+    mNumSpans       = std::min( mNumSpans + 1, mSpans.size() );
+}
+
+//==============================================================================================================================
+inline bool profiler_c::mcIsEnabled( void ) const noexcept {
+    return mIsEnabled;
+}
+
+//==============================================================================================================================
+inline int64_t profiler_c::mcNow( void ) const noexcept {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - mStart ).count();
+}
+
+//==============================================================================================================================
+inline size_t profiler_c::mcGetNumSpans( void ) const noexcept {
+    return mNumSpans;
+}
+
+//==============================================================================================================================
+inline size_t profiler_c::mcGetNumNames( void ) const noexcept {
+    return mNames.size();
+}
+
+//==============================================================================================================================
+inline auto profiler_c::mcGetSpan( size_t iSpan ) const noexcept ->const span_t& {
+    return mSpans[ ( mNext + mSpans.size() - mNumSpans + iSpan ) % mSpans.size() ];
+}
+
+//==============================================================================================================================
+// Spans become complete events ("ph":"X"), timestamps and durations are in microseconds as the format requires.
+//==============================================================================================================================
+inline void profiler_c::mcWriteChromeTrace( std::ostream& stream ) const {
+    const auto cFlags     = stream.flags();
+    const auto cPrecision = stream.precision();
+
+    stream << std::fixed << std::setprecision( 3 ) << "{\"traceEvents\":[";
+
+    for ( size_t iSpan = 0; iSpan < mNumSpans; ++iSpan ) {
+        const span_t& cSpan = mcGetSpan( iSpan );
+
+        stream << ( iSpan == 0 ? "\n" : ",\n" ) << "{\"name\":\"";
+
+        for ( const char cChar : *cSpan.pName ) {
+            if ( cChar == '"' || cChar == '\\' ) {
+                stream << '\\' << cChar;
+            } else if ( static_cast< unsigned char >( cChar ) < 0x20 ) {
+                stream << "\\u00" << "0123456789abcdef"[ cChar >> 4 ] << "0123456789abcdef"[ cChar & 0xf ];
+            } else {
+                stream << cChar;
+            }
+        }
+
+        stream << "\",\"cat\":\"" << cSpan.pCategory << "\",\"ph\":\"X\",\"ts\":" << cSpan.begin / 1000.0
+               << ",\"dur\":" << ( cSpan.end - cSpan.begin ) / 1000.0 << ",\"pid\":0,\"tid\":" << cSpan.threadId << "}";
+    }
+
+    stream << "\n]}\n";
+
+    stream.flags( cFlags );
+    stream.precision( cPrecision );
+}
+
+//==============================================================================================================================
+// Threads are numbered in the order they first record a span, the numbers are the "tid" of the trace.
+//==============================================================================================================================
+inline uint32_t profiler_c::mGetThreadId( void ) noexcept {
+    static std::atomic< uint32_t > sNumThreads { 0 };
+    thread_local const uint32_t    cThreadId { sNumThreads.fetch_add( 1, std::memory_order_relaxed ) };
+
+    return cThreadId;
+}
+
+//==============================================================================================================================
+// Only names not in the ring yet are copied, the others are counted once more.
+//==============================================================================================================================
+inline auto profiler_c::mIntern( const std::string& cName ) noexcept ->const std::string* {
+    if ( const auto cIt = mNames.find( cName ); cIt != mNames.end() ) {
+        ++cIt->second;
+        return &cIt->first;
+    }
+
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    try {
+#endif
+        return &mNames.emplace( cName, 1 ).first->first;
+#ifndef SMD_FBT_NO_EXCEPTIONS
+    } catch ( const std::bad_alloc& ) {
+        return nullptr;
+    }
+#endif
+}
+
+//==============================================================================================================================
+// The name is freed with the last span that refers to it.
+//==============================================================================================================================
+inline void profiler_c::mRelease( const std::string* cpName ) noexcept {
+    const auto cIt = mNames.find( *cpName );
+
+    if ( --cIt->second == 0 ) {
+        mNames.erase( cIt );
+    }
+}
+
+//==============================================================================================================================
+inline profiler_c::profiler_c( size_t capacity ) :
+    mStart( std::chrono::steady_clock::now() ),
+    mSpans( capacity ) {
+    if ( capacity == 0 ) {
+        SMD_FBT_THROW( "Can't profile into a ring of zero spans." );
+    }
+}
+
+//==============================================================================================================================
+inline profileSpan_c::profileSpan_c( profiler_c* pProfiler, const std::string& cName, const char* cpCategory ) noexcept :
+    mcpProfiler( pProfiler && pProfiler->mcIsEnabled() ? pProfiler : nullptr ),
+    mcName( cName ),
+    mcpCategory( cpCategory ) {
+    if ( mcpProfiler ) {
+        mBegin = mcpProfiler->mcNow();
+    }
+}
+
+//==============================================================================================================================
+inline profileSpan_c::~profileSpan_c( void ) noexcept {
+    if ( mcpProfiler ) {
+        mcpProfiler->mRecord( mcName, mcpCategory, mBegin, mcpProfiler->mcNow() );
+    }
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,162 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "parentnode_i.hpp"
+#include "sequencenode_c.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Selects the first branch that doesn't fail like 'selectorNode_c', but keeps a running branch going instead of restarting
+// it. A branch is guarded if it's a sequence starting with a condition. While a branch is running, the branches of higher
+// priority are checked by their guards only, a branch without a guard is ticked as a whole. When a higher guard passes, the
+// running branch is aborted, its state reset, and the higher branch continues after its guard. The running branch re-checks
+// its own guard too, then resumes from its running child.
+// The state is the index of the running branch plus one, so a zeroed state means no branch is running.
+//==============================================================================================================================
+template< typename timeData_t >
+class reactiveSelectorNode_c final : public parentNode_i< timeData_t > {
+    using parentNode_t   = parentNode_i< timeData_t >;
+    using node_t         = node_i< timeData_t >;
+    using context_t      = typename parentNode_t::context_t;
+    using sequenceNode_t = sequenceNode_c< timeData_t >;
+
+public:
+    using parentNode_t::cNoChild;
+
+    inline status_t mTick( context_t& context ) const noexcept override;
+
+    inline uint32_t mcGetRunningChild( const context_t& cContext ) const noexcept; // Or 'cNoChild' if none is running.
+
+    reactiveSelectorNode_c& operator=( const reactiveSelectorNode_c& ) = delete;
+    reactiveSelectorNode_c& operator=( reactiveSelectorNode_c&& )      noexcept = delete;
+    explicit inline         reactiveSelectorNode_c( std::string_view cName );
+    inline                  reactiveSelectorNode_c( const reactiveSelectorNode_c& cNode );
+    inline                  reactiveSelectorNode_c( reactiveSelectorNode_c&& node );
+                            ~reactiveSelectorNode_c( void )                    = default;
+
+private:
+    static inline bool mcIsGuarded( const node_t& cBranch ) noexcept;
+
+    inline status_t mcTickBranches( context_t& context ) const noexcept;
+
+    using parentNode_t::mChildren;
+};
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t reactiveSelectorNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    const profileSpan_c cSpan( context.pProfiler, parentNode_t::mcName, "node" );
+
+    tickSlice_t< timeData_t >* const cpSlice { context.pSlice }; // The guards are checked every time, so branches can't suspend.
+    context.pSlice = nullptr;
+
+    const status_t cStatus { mcTickBranches( context ) };
+    context.pSlice = cpSlice;
+
+    return cStatus;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t reactiveSelectorNode_c< timeData_t >::mcTickBranches( context_t& context ) const noexcept {
+    const uint32_t cNumChildren { static_cast< uint32_t >( mChildren.size() ) };
+    const uint32_t cRunning     { std::min( mcGetRunningChild( context ), cNumChildren ) };
+
+    for ( uint32_t iChild = 0; iChild < cNumChildren; ++iChild ) {
+        const node_t& cBranch = *mChildren[ iChild ];
+
+        status_t status;
+
+        if ( iChild <= cRunning && mcIsGuarded( cBranch ) ) {
+            if ( cBranch.mcGetChild( 0 )->mTick( context ) == status_t::FAILURE ) {
+                continue;
+            }
+
+            const auto&    cSequence = static_cast< const sequenceNode_t& >( cBranch );
+            const uint32_t cResume { iChild == cRunning ? cSequence.mcGetRunningChild( context ) : cNoChild };
+
+            status = cSequence.mTickFrom( context, cResume != cNoChild ? std::max( cResume, 1u ) : 1 );
+
+        } else if ( iChild == cRunning && cBranch.mcKind == nodeKind_t::SEQUENCE ) {
+            const auto&    cSequence = static_cast< const sequenceNode_t& >( cBranch );
+            const uint32_t cResume { cSequence.mcGetRunningChild( context ) };
+
+            status = cSequence.mTickFrom( context, cResume != cNoChild ? cResume : 0 );
+
+        } else {
+            status = cBranch.mTick( context );
+        }
+
+        if ( status != status_t::FAILURE ) {
+            if ( cRunning < cNumChildren && iChild != cRunning ) {
+                mChildren[ cRunning ]->mcResetState( context );
+            }
+
+            this->mcStoreState( context, status == status_t::RUNNING ? iChild + 1 : 0u );
+            return status;
+        }
+    }
+
+    if ( cRunning < cNumChildren ) {
+        mChildren[ cRunning ]->mcResetState( context );
+    }
+
+    this->mcStoreState( context, 0u );
+    return status_t::FAILURE;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t reactiveSelectorNode_c< timeData_t >::mcGetRunningChild( const context_t& cContext ) const noexcept {
+    return this->template mcLoadState< uint32_t >( cContext ) - 1;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline reactiveSelectorNode_c< timeData_t >::reactiveSelectorNode_c( std::string_view cName ) :
+    parentNode_t( nodeKind_t::REACTIVE_SELECTOR, cName, SIZE_MAX, sizeof( uint32_t ) ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline reactiveSelectorNode_c< timeData_t >::reactiveSelectorNode_c( const reactiveSelectorNode_c& cNode ) :
+    parentNode_t( cNode ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline reactiveSelectorNode_c< timeData_t >::reactiveSelectorNode_c( reactiveSelectorNode_c&& node ) :
+    parentNode_t( std::move( node ) ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool reactiveSelectorNode_c< timeData_t >::mcIsGuarded( const node_t& cBranch ) noexcept {
+    return cBranch.mcKind == nodeKind_t::SEQUENCE && cBranch.mcGetChild( 0 )->mcKind == nodeKind_t::CONDITION;
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,105 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Adapts a memory resource of the runtime to the standard allocator interface, e.g. 'arena_c' for the state block of
+// 'instance_c' or 'scratch_c' for a 'std::vector' of a leaf. The resource hands out memory aligned to its 'cAlign' by
+// 'mAllocate' and takes it back by 'mRelease', allocators of the same resource are equal whatever they allocate.
+//==============================================================================================================================
+template< typename type_t, typename resource_t >
+class resourceAllocator_c { // Not final, the containers derive from their allocators.
+    template< typename, typename >
+    friend class resourceAllocator_c;
+
+public:
+    using value_type = type_t;
+
+    template< typename other_t >
+    using rebound_t = resourceAllocator_c< other_t, resource_t >;
+
+    inline type_t* allocate( size_t n );
+    inline void    deallocate( type_t* p, size_t n ) noexcept;
+
+    template< typename other_t >
+    inline bool operator==( const rebound_t< other_t >& cOther ) const noexcept;
+    template< typename other_t >
+    inline bool operator!=( const rebound_t< other_t >& cOther ) const noexcept;
+
+    inline resourceAllocator_c( resource_t& resource ) noexcept;
+    template< typename other_t >
+    inline resourceAllocator_c( const rebound_t< other_t >& cOther ) noexcept;
+
+private:
+    resource_t* mpResource;
+};
+
+//==============================================================================================================================
+template< typename type_t, typename resource_t >
+inline type_t* resourceAllocator_c< type_t, resource_t >::allocate( size_t n ) {
+    static_assert( alignof( type_t ) <= resource_t::cAlign );
+
+    return static_cast< type_t* >( mpResource->mAllocate( n * sizeof( type_t ) ) );
+}
+
+//==============================================================================================================================
+template< typename type_t, typename resource_t >
+inline void resourceAllocator_c< type_t, resource_t >::deallocate( type_t*, size_t n ) noexcept {
+    mpResource->mRelease( n * sizeof( type_t ) );
+}
+
+//==============================================================================================================================
+template< typename type_t, typename resource_t >
+template< typename other_t >
+inline bool resourceAllocator_c< type_t, resource_t >::operator==( const rebound_t< other_t >& cOther ) const noexcept {
+    return mpResource == cOther.mpResource;
+}
+
+//==============================================================================================================================
+template< typename type_t, typename resource_t >
+template< typename other_t >
+inline bool resourceAllocator_c< type_t, resource_t >::operator!=( const rebound_t< other_t >& cOther ) const noexcept {
+    return mpResource != cOther.mpResource;
+}
+
+//==============================================================================================================================
+template< typename type_t, typename resource_t >
+inline resourceAllocator_c< type_t, resource_t >::resourceAllocator_c( resource_t& resource ) noexcept :
+    mpResource( &resource ) {
+}
+
+//==============================================================================================================================
+template< typename type_t, typename resource_t >
+template< typename other_t >
+inline resourceAllocator_c< type_t, resource_t >::resourceAllocator_c( const rebound_t< other_t >& cOther ) noexcept :
+    mpResource( cOther.mpResource ) {
+}
+
+} // namespace smd::fbt
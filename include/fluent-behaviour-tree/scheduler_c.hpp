@@ -0,0 +1,220 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+#pragma once
+
+#include "common.hpp"
+#include "instance_c.hpp"
+#include "node_i.hpp"
+#include "waitnode_c.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Ticks only the instances that are awake. An instance falls asleep when its tick returns RUNNING while a leaf waits for an
+// event (see 'waitNode_c'), then it isn't ticked at all until 'mSignal' fires the event. Signalled instances go to a wake-up
+// queue and are ticked again from the next 'mTick' on, with the event passed to the waiting leaf. So populations that are
+// mostly idle cost about nothing per tick.
+//
+// A tree falls asleep as soon as a waiting leaf runs, it shouldn't wait beside other running branches of a parallel. The
+// scheduler references the instances, they must outlive it and must not move.
+//
+// 'mAdd' reserves the queues for the whole population and registers the events the tree of the instance waits for, so the
+// sleeping agents are linked through the agents themselves and neither 'mTick' nor 'mSignal' allocates. Agents waiting for an
+// event not registered (e.g. of a tree edited or a lazy sub-tree built later) sleep in a list 'mSignal' scans.
+//==============================================================================================================================
+template< typename timeData_t >
+class scheduler_c final {
+    using instance_t = instance_c< timeData_t >;
+    using context_t  = tickContext_t< timeData_t >;
+
+public:
+    inline uint32_t mAdd( instance_t& instance );      // Returns the index of the agent, the instance starts awake.
+    inline void     mTick( param_t< timeData_t > timeData, profiler_c* pProfiler = nullptr ) noexcept;
+    inline void     mSignal( uint32_t event ) noexcept; // May be called by the leaves while ticking.
+
+    inline bool     mcIsAwake( uint32_t iAgent )   const noexcept;
+    inline status_t mcGetStatus( uint32_t iAgent ) const noexcept; // Of the last tick of the agent.
+    inline size_t   mcGetNumAwake( void )          const noexcept; // Including the agents in the wake-up queue.
+    inline size_t   mcGetNumAgents( void )         const noexcept;
+
+    scheduler_c& operator=( const scheduler_c& ) = delete;
+    scheduler_c& operator=( scheduler_c&& )      noexcept = default;
+                 scheduler_c( void )             = default;
+                 scheduler_c( const scheduler_c& ) = delete;
+                 scheduler_c( scheduler_c&& )      noexcept = default;
+                 ~scheduler_c( void )              = default;
+
+private:
+    static constexpr uint32_t cNoAgent { UINT32_MAX };
+
+    struct agent_t final {
+        instance_t* pInstance;
+        uint32_t    sleepEvent { cNoEvent };         // Event the agent sleeps until.
+        uint32_t    wakeEvent  { cNoEvent };         // Event that woke the agent up, passed to its next tick.
+        uint32_t    iNext      { cNoAgent };         // Next agent sleeping in the same list.
+        status_t    status     { status_t::RUNNING };
+    };
+
+    struct sleepers_t final { // Agents in the order they fell asleep.
+        uint32_t iFirst { cNoAgent };
+        uint32_t iLast  { cNoAgent };
+    };
+
+    inline void mSleep( sleepers_t& sleepers, uint32_t iAgent ) noexcept;
+
+    std::vector< agent_t >                     mAgents;
+    std::vector< uint32_t >                    mAwake;        // Agents ticked by 'mTick', in the order they woke up.
+    std::vector< uint32_t >                    mWakeQueue;    // Agents woken up since the last 'mTick'.
+    std::unordered_map< uint32_t, sleepers_t > mSleeping;     // Agents by the event they sleep until, if registered.
+    sleepers_t                                 mUnregistered; // Agents sleeping until events not registered.
+};
+
+//==============================================================================================================================
+// Every agent is either awake, in the wake-up queue or asleep, so both queues are reserved for the whole population.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t scheduler_c< timeData_t >::mAdd( instance_t& instance ) {
+    const uint32_t cAgent { static_cast< uint32_t >( mAgents.size() ) };
+
+    instance.mcGetTree().mcGetRoot()->mcVisit( [ this ]( const node_i< timeData_t >& cNode, uint32_t ) {
+        if ( cNode.mcKind == nodeKind_t::WAIT ) {
+            mSleeping.try_emplace( static_cast< const waitNode_c< timeData_t >& >( cNode ).mcEvent );
+        }
+
+        return true;
+    } );
+
+    mAgents.emplace_back( agent_t { &instance } );
+    mAwake.reserve( mAgents.capacity() );
+    mWakeQueue.reserve( mAgents.capacity() );
+    mAwake.emplace_back( cAgent );
+
+    return cAgent;
+}
+
+//==============================================================================================================================
+// Ticks the awake agents in order, agents that wait for an event afterwards fall asleep.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void scheduler_c< timeData_t >::mTick( param_t< timeData_t > timeData, profiler_c* pProfiler ) noexcept {
+    mAwake.insert( mAwake.end(), mWakeQueue.begin(), mWakeQueue.end() );
+    mWakeQueue.clear();
+
+    size_t numAwake { 0 };
+
+    for ( const uint32_t cAgent : mAwake ) {
+        agent_t& agent = mAgents[ cAgent ];
+
+        context_t context { timeData, nullptr, pProfiler, nullptr, agent.wakeEvent };
+
+        agent.wakeEvent = cNoEvent;
+        agent.status    = agent.pInstance->mTick( context );
+
+        if ( agent.status == status_t::RUNNING && context.waitEvent != cNoEvent ) {
+            const auto cIt = mSleeping.find( context.waitEvent );
+
+            agent.sleepEvent = context.waitEvent;
+            mSleep( cIt != mSleeping.end() ? cIt->second : mUnregistered, cAgent );
+        } else {
+            mAwake[ numAwake++ ] = cAgent;
+        }
+    }
+
+    mAwake.resize( numAwake );
+}
+
+//==============================================================================================================================
+// Moves the agents sleeping until 'event' to the wake-up queue, in the order they fell asleep.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void scheduler_c< timeData_t >::mSignal( uint32_t event ) noexcept {
+    auto wake = [ this, event ]( uint32_t iAgent ) {
+        mAgents[ iAgent ].sleepEvent = cNoEvent;
+        mAgents[ iAgent ].wakeEvent  = event;
+        mWakeQueue.emplace_back( iAgent );
+    };
+
+    if ( const auto cIt = mSleeping.find( event ); cIt != mSleeping.end() ) {
+        for ( uint32_t iAgent = cIt->second.iFirst; iAgent != cNoAgent; iAgent = mAgents[ iAgent ].iNext ) {
+            wake( iAgent );
+        }
+
+        cIt->second = sleepers_t {};
+    }
+
+    sleepers_t remaining;
+
+    for ( uint32_t iAgent = mUnregistered.iFirst, iNext; iAgent != cNoAgent; iAgent = iNext ) {
+        iNext = mAgents[ iAgent ].iNext;
+
+        if ( mAgents[ iAgent ].sleepEvent == event ) {
+            wake( iAgent );
+        } else {
+            mSleep( remaining, iAgent );
+        }
+    }
+
+    mUnregistered = remaining;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void scheduler_c< timeData_t >::mSleep( sleepers_t& sleepers, uint32_t iAgent ) noexcept {
+    mAgents[ iAgent ].iNext = cNoAgent;
+
+    if ( sleepers.iLast != cNoAgent ) {
+        mAgents[ sleepers.iLast ].iNext = iAgent;
+    } else {
+        sleepers.iFirst = iAgent;
+    }
+
+    sleepers.iLast = iAgent;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool scheduler_c< timeData_t >::mcIsAwake( uint32_t iAgent ) const noexcept {
+    return mAgents[ iAgent ].sleepEvent == cNoEvent;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t scheduler_c< timeData_t >::mcGetStatus( uint32_t iAgent ) const noexcept {
+    return mAgents[ iAgent ].status;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t scheduler_c< timeData_t >::mcGetNumAwake( void ) const noexcept {
+    return mAwake.size() + mWakeQueue.size();
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t scheduler_c< timeData_t >::mcGetNumAgents( void ) const noexcept {
+    return mAgents.size();
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,210 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+#pragma once
+
+#include "common.hpp"
+#include "resourceallocator_c.hpp"
+
+#include <cstddef>
+#include <new>
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Bump allocator for the temporary buffers of the leaves, e.g. neighbour lists or candidate targets. Every root tick rewinds
+// it to where it started once the tick returns, so the memory lives until the end of the 'mTick' that handed it out, a
+// suspended tick doesn't keep it either. Nothing is freed on its own. When rewound to the start after using several blocks
+// they're freed and the next block is made large enough for all of them, so a steady workload allocates from a single block
+// and doesn't call the heap at all.
+//==============================================================================================================================
+class scratch_c final {
+public:
+    static constexpr size_t cAlign { alignof( std::max_align_t ) };
+
+    struct mark_t final {
+        size_t iBlock; // Block being bumped.
+        size_t offset; // Free space of the block starts here.
+    };
+
+    inline void*  mAllocate( size_t size );                      // Aligned to 'cAlign'.
+    inline void   mRelease( size_t size )              noexcept; // A no-op, the memory is reused after the tick.
+    inline void   mRewind( const mark_t& cMark )       noexcept; // Memory handed out since the mark is reused.
+    inline mark_t mcGetMark( void )              const noexcept;
+    inline size_t mcGetNumBlocks( void )         const noexcept;
+    inline size_t mcGetCapacity( void )          const noexcept; // Bytes of all blocks.
+
+    static inline scratch_c& mGetThreadScratch( void ) noexcept; // Used by ticks whose context has none.
+
+    scratch_c&      operator=( const scratch_c& ) = delete;
+    scratch_c&      operator=( scratch_c&& )      = delete;
+    explicit inline scratch_c( size_t blockSize = 16 * 1024 ) noexcept;
+                    scratch_c( const scratch_c& ) = delete;
+                    scratch_c( scratch_c&& )      = delete;
+    inline          ~scratch_c( void );
+
+private:
+    struct block_t final {
+        uint8_t* pMemory;
+        size_t   size;
+    };
+
+    inline void mFree( void ) noexcept;
+
+    std::vector< block_t > mBlocks;       // Blocks in the order they're bumped.
+    size_t                 mBlockSize;    // Size of the next new block, larger allocations get a block of their own.
+    size_t                 mIBlock { 0 }; // Block being bumped.
+    size_t                 mOffset { 0 }; // Free space of the block being bumped starts here.
+};
+
+//==============================================================================================================================
+// Takes the scratch memory of a root tick: the thread's scratch if the context has none, then rewinds it when the tick returns.
+// Nested root ticks, e.g. a leaf ticking another instance, only rewind what they allocated themselves.
+//==============================================================================================================================
+class scratchScope_c final {
+public:
+    scratchScope_c& operator=( const scratchScope_c& ) = delete;
+    scratchScope_c& operator=( scratchScope_c&& )      = delete;
+    explicit inline scratchScope_c( scratch_c*& pScratch ) noexcept;
+                    scratchScope_c( const scratchScope_c& ) = delete;
+                    scratchScope_c( scratchScope_c&& )      = delete;
+    inline          ~scratchScope_c( void );
+
+private:
+    scratch_c*&             mpScratch;  // Of the context.
+    scratch_c* const        mpPrevious; // Restored in the context when the tick returns.
+    const scratch_c::mark_t mcMark;     // Rewound to when the tick returns.
+};
+
+//==============================================================================================================================
+// Adapts the scratch memory to the standard allocator interface, e.g. for a 'std::vector' of a leaf. Deallocation is a no-op,
+// the buffers a growing container leaves behind are reused after the tick.
+//==============================================================================================================================
+template< typename type_t >
+using scratchAllocator_c = resourceAllocator_c< type_t, scratch_c >;
+
+//==============================================================================================================================
+inline void* scratch_c::mAllocate( size_t size ) {
+    const size_t cSize { ( std::max< size_t >( size, 1 ) + cAlign - 1 ) / cAlign * cAlign };
+
+    // Blocks after the current one are left from before a rewind, they're reused if the allocation fits.
+    while ( mIBlock < mBlocks.size() && mOffset + cSize > mBlocks[ mIBlock ].size ) {
+        ++mIBlock;
+        mOffset = 0;
+    }
+
+    if ( mIBlock == mBlocks.size() ) {
+        const size_t cBlockSize { std::max( cSize, mBlockSize ) };
+
+        mBlocks.reserve( mBlocks.size() + 1 );
+        mBlocks.push_back( block_t { static_cast< uint8_t* >( ::operator new( cBlockSize, std::align_val_t { cAlign } ) ),
+                                     cBlockSize } );
+    }
+
+    void* const cpMemory { mBlocks[ mIBlock ].pMemory + mOffset };
+
+    mOffset += cSize;
+
+    return cpMemory;
+}
+
+//==============================================================================================================================
+inline void scratch_c::mRelease( size_t ) noexcept {
+}
+
+//==============================================================================================================================
+inline void scratch_c::mRewind( const mark_t& cMark ) noexcept {
+    mIBlock = cMark.iBlock;
+    mOffset = cMark.offset;
+
+    if ( 0 == mIBlock && 0 == mOffset && mBlocks.size() > 1 ) {
+        mBlockSize = mcGetCapacity();
+        mFree();
+    }
+}
+
+//==============================================================================================================================
+inline auto scratch_c::mcGetMark( void ) const noexcept ->mark_t {
+    return { mIBlock, mOffset };
+}
+
+//==============================================================================================================================
+inline size_t scratch_c::mcGetNumBlocks( void ) const noexcept {
+    return mBlocks.size();
+}
+
+//==============================================================================================================================
+inline size_t scratch_c::mcGetCapacity( void ) const noexcept {
+    size_t capacity { 0 };
+
+    for ( const block_t& cBlock : mBlocks ) {
+        capacity += cBlock.size;
+    }
+
+    return capacity;
+}
+
+//==============================================================================================================================
+inline scratch_c& scratch_c::mGetThreadScratch( void ) noexcept {
+    thread_local scratch_c scratch;
+
+    return scratch;
+}
+
+//==============================================================================================================================
+inline scratch_c::scratch_c( size_t blockSize ) noexcept :
+    mBlockSize( ( std::max< size_t >( blockSize, cAlign ) + cAlign - 1 ) / cAlign * cAlign ) {
+}
+
+//==============================================================================================================================
+inline scratch_c::~scratch_c( void ) {
+    mFree();
+}
+
+//==============================================================================================================================
+inline void scratch_c::mFree( void ) noexcept {
+    for ( const block_t& cBlock : mBlocks ) {
+        ::operator delete( cBlock.pMemory, std::align_val_t { cAlign } );
+    }
+
+    mBlocks.clear();
+}
+
+//==============================================================================================================================
+inline scratchScope_c::scratchScope_c( scratch_c*& pScratch ) noexcept :
+    mpScratch( pScratch ),
+    mpPrevious( pScratch ),
+    mcMark( ( pScratch ? *pScratch : scratch_c::mGetThreadScratch() ).mcGetMark() ) {
+    if ( !mpScratch ) {
+        mpScratch = &scratch_c::mGetThreadScratch();
+    }
+}
+
+//==============================================================================================================================
+inline scratchScope_c::~scratchScope_c( void ) {
+    mpScratch->mRewind( mcMark );
+    mpScratch = mpPrevious;
+}
+
+} // namespace smd::fbt
@@ -33,56 +33,99 @@ namespace smd::fbt {
 
 //==============================================================================================================================
 // Selects the first node that succeeds. Tries successive nodes until it finds one that doesn't fail.
+// The state is the index of the child that returned RUNNING plus one, so a zeroed state means no child is running.
 //==============================================================================================================================
 template< typename timeData_t >
 class selectorNode_c final : public parentNode_i< timeData_t > {
     using parentNode_t = parentNode_i< timeData_t >;
-    using nodePtr_t    = std::shared_ptr< node_i< timeData_t > >;
+    using context_t    = typename parentNode_t::context_t;
 
 public:
-    inline status_t mTick( timeData_t time )      override;
-    inline void     mAddChild( nodePtr_t pChild ) override;
+    using parentNode_t::cNoChild;
+
+    inline status_t mTick( context_t& context )                                        const noexcept override;
+    inline status_t mTickFrom( context_t& context, uint32_t iFirst )                   const noexcept; // Skips the children before 'iFirst'.
+    inline status_t mResume( context_t& context, uint32_t iChild, status_t childStatus ) const noexcept override;
+
+    inline uint32_t mcGetRunningChild( const context_t& cContext ) const noexcept;          // Or 'cNoChild' if none is running.
+    inline uint32_t mcGetResumeChild( const context_t& cContext )  const noexcept override; // The running child.
 
     selectorNode_c& operator=( const selectorNode_c& ) = delete;
     selectorNode_c& operator=( selectorNode_c&& )      noexcept = delete;
-    explicit inline selectorNode_c( const std::string& cName );
+    explicit inline selectorNode_c( std::string_view cName );
     inline          selectorNode_c( const selectorNode_c& cNode );
-                    selectorNode_c( selectorNode_c&& ) noexcept = delete;
+    inline          selectorNode_c( selectorNode_c&& node );
                     ~selectorNode_c( void )            = default;
 
 private:
-    std::vector< nodePtr_t > mChildren;
+    using parentNode_t::mChildren;
 };
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline status_t selectorNode_c< timeData_t >::mTick( timeData_t time ) {
-    for ( auto ipChild = mChildren.cbegin(); ipChild != mChildren.cend(); ++ipChild ) {
-        const status_t cStatus { ( *ipChild )->mTick( time ) };
+inline status_t selectorNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    return mTickFrom( context, 0 );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t selectorNode_c< timeData_t >::mTickFrom( context_t& context, uint32_t iFirst ) const noexcept {
+    const profileSpan_c cSpan( context.pProfiler, parentNode_t::mcName, "node" );
+
+    for ( uint32_t iChild = iFirst; iChild < mChildren.size(); ++iChild ) {
+        if ( iChild > iFirst && context.pSlice && context.pSlice->mSuspend( *this, iChild - 1, status_t::FAILURE ) ) {
+            this->mcStoreState( context, iChild );
+            return status_t::RUNNING;
+        }
+
+        const status_t cStatus { mChildren[ iChild ]->mTick( context ) };
 
         if ( cStatus != status_t::FAILURE ) {
+            this->mcStoreState( context, cStatus == status_t::RUNNING ? iChild + 1 : 0u );
             return cStatus;
         }
     }
 
+    this->mcStoreState( context, 0u );
     return status_t::FAILURE;
 }
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline void selectorNode_c< timeData_t >::mAddChild( nodePtr_t pChild ) {
-    mChildren.emplace_back( move( pChild ) );
+inline status_t selectorNode_c< timeData_t >::mResume( context_t& context, uint32_t iChild, status_t childStatus ) const noexcept {
+    if ( childStatus == status_t::FAILURE ) {
+        return mTickFrom( context, iChild + 1 );
+    }
+
+    this->mcStoreState( context, childStatus == status_t::RUNNING ? iChild + 1 : 0u );
+    return childStatus;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t selectorNode_c< timeData_t >::mcGetRunningChild( const context_t& cContext ) const noexcept {
+    return this->template mcLoadState< uint32_t >( cContext ) - 1;
 }
 
 //==============================================================================================================================
 template< typename timeData_t >
-inline selectorNode_c< timeData_t >::selectorNode_c( const std::string& cName ) :
-    parentNode_t( cName ) {}
+inline uint32_t selectorNode_c< timeData_t >::mcGetResumeChild( const context_t& cContext ) const noexcept {
+    return mcGetRunningChild( cContext );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline selectorNode_c< timeData_t >::selectorNode_c( std::string_view cName ) :
+    parentNode_t( nodeKind_t::SELECTOR, cName, SIZE_MAX, sizeof( uint32_t ) ) {}
 
 //==============================================================================================================================
 template< typename timeData_t >
 inline selectorNode_c< timeData_t >::selectorNode_c( const selectorNode_c& cNode ) :
-    parentNode_t( cNode ),
-    mChildren( cNode.mChildren ) {}
+    parentNode_t( cNode ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline selectorNode_c< timeData_t >::selectorNode_c( selectorNode_c&& node ) :
+    parentNode_t( std::move( node ) ) {}
 
 } // namespace smd::fbt
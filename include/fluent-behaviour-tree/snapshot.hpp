@@ -0,0 +1,64 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Snapshots are copies of the state block of an instance, 'instance_c::mcSnapshot' and 'mRestore' copy them in and out. The
+// state block is plain data, so a snapshot is taken and restored by a single 'memcpy' of a few words.
+//==============================================================================================================================
+using stateWord_t = uint64_t; // State blocks and snapshots are arrays of these.
+
+//==============================================================================================================================
+// Compares two snapshots of the same tree word by word. Returns the number of words that differ, and writes their indices to
+// 'pChanged' if given.
+//==============================================================================================================================
+inline size_t diffStates( const stateWord_t* cpA, const stateWord_t* cpB, size_t numWords,
+                          std::vector< uint32_t >* pChanged = nullptr ) {
+    size_t numChanged { 0 };
+
+    for ( size_t iWord = 0; iWord < numWords; ++iWord ) {
+        if ( cpA[ iWord ] != cpB[ iWord ] ) {
+            ++numChanged;
+
+            if ( pChanged ) {
+                pChanged->emplace_back( static_cast< uint32_t >( iWord ) );
+            }
+        }
+    }
+
+    return numChanged;
+}
+
+//==============================================================================================================================
+inline bool isSameState( const stateWord_t* cpA, const stateWord_t* cpB, size_t numWords ) noexcept {
+    return std::memcmp( cpA, cpB, numWords * sizeof( stateWord_t ) ) == 0;
+}
+
+} // namespace smd::fbt
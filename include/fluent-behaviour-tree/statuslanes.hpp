@@ -0,0 +1,190 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Compact status encoding. Every 'status_t' fits into 2 bits, so 32 statuses are packed into a 64-bit word. For lock-step
+// evaluation of up to 64 agents, statuses are split into two bit planes instead: lane 'i' is SUCCESS when bit 'i' of 'success'
+// is set, FAILURE when bit 'i' of 'failure' is set and RUNNING when neither is. Composite and decorator logic over the planes
+// is plain bitwise arithmetic without branches.
+//==============================================================================================================================
+constexpr uint32_t cStatusBits     { 2 };
+constexpr uint32_t cStatusesInWord { 64 / cStatusBits };
+constexpr uint64_t cStatusMask     { ( 1 << cStatusBits ) - 1 };
+
+static_assert( 0 == static_cast< uint32_t >( status_t::SUCCESS ) &&
+               1 == static_cast< uint32_t >( status_t::FAILURE ) &&
+               2 == static_cast< uint32_t >( status_t::RUNNING ), "Status encoding is used by branchless kernels." );
+
+//==============================================================================================================================
+struct statusLanes_t final {
+    uint64_t success; // Lanes that returned SUCCESS.
+    uint64_t failure; // Lanes that returned FAILURE.
+};
+
+//==============================================================================================================================
+// Swaps SUCCESS and FAILURE, RUNNING passes through.
+//==============================================================================================================================
+constexpr status_t invertStatus( status_t status ) noexcept {
+    const uint32_t cValue { static_cast< uint32_t >( status ) };
+
+    return static_cast< status_t >( cValue ^ ( ~cValue >> 1 & 1 ) );
+}
+
+//==============================================================================================================================
+constexpr statusLanes_t invertLanes( statusLanes_t lanes ) noexcept {
+    return { lanes.failure, lanes.success };
+}
+
+//==============================================================================================================================
+constexpr uint64_t runningLanes( statusLanes_t lanes, uint64_t validLanes ) noexcept {
+    return validLanes & ~( lanes.success | lanes.failure );
+}
+
+//==============================================================================================================================
+// Converts up to 64 statuses to the bit planes, lane 'i' takes 'pStatuses[ i ]'.
+//==============================================================================================================================
+inline statusLanes_t toLanes( const status_t* pStatuses, size_t numStatuses ) noexcept {
+    statusLanes_t lanes { 0, 0 };
+
+    for ( size_t iLane { 0 }; iLane < numStatuses; ++iLane ) {
+        const uint64_t cValue { static_cast< uint32_t >( pStatuses[ iLane ] ) };
+
+        lanes.success |= uint64_t( cValue == 0 ) << iLane;
+        lanes.failure |= ( cValue & 1 ) << iLane;
+    }
+
+    return lanes;
+}
+
+//==============================================================================================================================
+constexpr status_t laneStatus( statusLanes_t lanes, size_t iLane ) noexcept {
+    const uint32_t cFailure { static_cast< uint32_t >( lanes.failure >> iLane & 1 ) };
+    const uint32_t cSuccess { static_cast< uint32_t >( lanes.success >> iLane & 1 ) };
+
+    return static_cast< status_t >( cFailure | ( ( cFailure | cSuccess ) ^ 1 ) << 1 );
+}
+
+//==============================================================================================================================
+// Packs statuses by 2 bits, 'pWords' must have room for '( numStatuses + 31 ) / 32' words.
+//==============================================================================================================================
+inline void packStatuses( const status_t* pStatuses, size_t numStatuses, uint64_t* pWords ) noexcept {
+    for ( size_t iWord { 0 }; iWord < ( numStatuses + cStatusesInWord - 1 ) / cStatusesInWord; ++iWord ) {
+        pWords[ iWord ] = 0;
+    }
+
+    for ( size_t iStatus { 0 }; iStatus < numStatuses; ++iStatus ) {
+        pWords[ iStatus / cStatusesInWord ] |=
+            uint64_t( static_cast< uint32_t >( pStatuses[ iStatus ] ) ) << ( iStatus % cStatusesInWord * cStatusBits );
+    }
+}
+
+//==============================================================================================================================
+constexpr status_t unpackStatus( const uint64_t* pWords, size_t iStatus ) noexcept {
+    return static_cast< status_t >(
+        pWords[ iStatus / cStatusesInWord ] >> ( iStatus % cStatusesInWord * cStatusBits ) & cStatusMask );
+}
+
+//==============================================================================================================================
+// Sequence logic over lanes. Children are added in order; 'mcGetPending()' is the set of lanes that still need the next child
+// to be ticked, all other lanes are already decided.
+//==============================================================================================================================
+class sequenceLanes_c final {
+public:
+    constexpr void          mAdd( statusLanes_t child ) noexcept;
+    constexpr uint64_t      mcGetPending( void )        const noexcept;
+    constexpr statusLanes_t mcGetResult( void )         const noexcept;
+
+    constexpr explicit sequenceLanes_c( uint64_t validLanes ) noexcept;
+
+private:
+    uint64_t mPending; // Lanes where all children so far succeeded.
+    uint64_t mFailure; // Lanes where the first not succeeded child failed.
+};
+
+//==============================================================================================================================
+constexpr void sequenceLanes_c::mAdd( statusLanes_t child ) noexcept {
+    mFailure |= mPending & child.failure;
+    mPending &= child.success;
+}
+
+//==============================================================================================================================
+constexpr uint64_t sequenceLanes_c::mcGetPending( void ) const noexcept {
+    return mPending;
+}
+
+//==============================================================================================================================
+constexpr statusLanes_t sequenceLanes_c::mcGetResult( void ) const noexcept {
+    return { mPending, mFailure };
+}
+
+//==============================================================================================================================
+constexpr sequenceLanes_c::sequenceLanes_c( uint64_t validLanes ) noexcept :
+    mPending( validLanes ),
+    mFailure( 0 ) {}
+
+//==============================================================================================================================
+// Selector logic over lanes, the dual of 'sequenceLanes_c'.
+//==============================================================================================================================
+class selectorLanes_c final {
+public:
+    constexpr void          mAdd( statusLanes_t child ) noexcept;
+    constexpr uint64_t      mcGetPending( void )        const noexcept;
+    constexpr statusLanes_t mcGetResult( void )         const noexcept;
+
+    constexpr explicit selectorLanes_c( uint64_t validLanes ) noexcept;
+
+private:
+    uint64_t mPending; // Lanes where all children so far failed.
+    uint64_t mSuccess; // Lanes where the first not failed child succeeded.
+};
+
+//==============================================================================================================================
+constexpr void selectorLanes_c::mAdd( statusLanes_t child ) noexcept {
+    mSuccess |= mPending & child.success;
+    mPending &= child.failure;
+}
+
+//==============================================================================================================================
+constexpr uint64_t selectorLanes_c::mcGetPending( void ) const noexcept {
+    return mPending;
+}
+
+//==============================================================================================================================
+constexpr statusLanes_t selectorLanes_c::mcGetResult( void ) const noexcept {
+    return { mSuccess, mPending };
+}
+
+//==============================================================================================================================
+constexpr selectorLanes_c::selectorLanes_c( uint64_t validLanes ) noexcept :
+    mPending( validLanes ),
+    mSuccess( 0 ) {}
+
+} // namespace smd::fbt
@@ -0,0 +1,159 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "conditionnode_c.hpp"
+#include "parallelnode_c.hpp"
+#include "waitnode_c.hpp"
+#include "tree_c.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Two trees are structurally identical when their nodes have the same kinds, names and parameters in the same places. Leaves
+// are identified by their names, as images fix them up by name, so trees built from the same description hash the same and
+// key a cache of their images, or find the candidates 'library_c::mIntern' compares by their functions too. Spliced trees are
+// part of the structure of the trees that splice them.
+//==============================================================================================================================
+enum class change_t : uint32_t {
+    ADDED,   // The node is only in the second tree.
+    REMOVED, // The node is only in the first tree.
+    CHANGED  // The node has another kind, name or parameters in the second tree.
+};
+
+//==============================================================================================================================
+struct treeChange_t final {
+    change_t    change;
+    std::string path; // Names from the root separated by '/', in the second tree for added nodes and in the first one otherwise.
+};
+
+//==============================================================================================================================
+// Parameters of a node beside its kind and name: thresholds of a parallel, the event of a wait node, the state capacity of a
+// lazy sub-tree.
+//==============================================================================================================================
+template< typename timeData_t >
+inline std::array< uint32_t, 2 > structuralParams( const node_i< timeData_t >& cNode ) noexcept {
+    switch ( cNode.mcKind ) {
+        case nodeKind_t::PARALLEL: {
+            const auto& cParallel = static_cast< const parallelNode_c< timeData_t >& >( cNode );
+
+            return { cParallel.mcGetNumToFail(), cParallel.mcGetNumToSucceed() };
+        }
+        case nodeKind_t::WAIT:
+            return { static_cast< const waitNode_c< timeData_t >& >( cNode ).mcEvent, 0 };
+        case nodeKind_t::LAZY_SUBTREE:
+            return { cNode.mcStateSize, 0 };
+        case nodeKind_t::CONDITION:
+            return { static_cast< const conditionNode_c< timeData_t >& >( cNode ).mcIsShared, 0 };
+        default:
+            return { 0, 0 };
+    }
+}
+
+//==============================================================================================================================
+// 64-bit FNV-1a of the nodes in pre-order, each hashed as its kind, name, parameters and number of children.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint64_t structuralHash( const node_i< timeData_t >& cRoot ) noexcept {
+    uint64_t hash { 14695981039346656037ull };
+
+    auto add = [ &hash ]( const void* cpData, size_t numBytes ) {
+        for ( size_t iByte = 0; iByte < numBytes; ++iByte ) {
+            hash = ( hash ^ static_cast< const uint8_t* >( cpData )[ iByte ] ) * 1099511628211ull;
+        }
+    };
+
+    cRoot.mcVisit( [ &add ]( const node_i< timeData_t >& cNode, uint32_t ) {
+        const uint32_t                  cKind { static_cast< uint32_t >( cNode.mcKind ) };
+        const uint32_t                  cNameSize { static_cast< uint32_t >( cNode.mcName.size() ) };
+        const std::array< uint32_t, 2 > cParams { structuralParams( cNode ) };
+        const uint32_t                  cNumChildren { static_cast< uint32_t >( cNode.mcGetNumChildren() ) };
+
+        add( &cKind, sizeof( cKind ) );
+        add( &cNameSize, sizeof( cNameSize ) );
+        add( cNode.mcName.data(), cNameSize );
+        add( cParams.data(), sizeof( cParams ) );
+        add( &cNumChildren, sizeof( cNumChildren ) );
+
+        return true;
+    } );
+
+    return hash;
+}
+
+//==============================================================================================================================
+// Includes whether the tree has memory and shares guards, as they change how the tree ticks.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint64_t structuralHash( const tree_c< timeData_t >& cTree ) noexcept {
+    const uint64_t cFlags { uint64_t { cTree.mcHasMemory() } | uint64_t { cTree.mcSharesGuards() } << 1 };
+
+    return ( structuralHash( *cTree.mcGetRoot() ) ^ cFlags ) * 1099511628211ull;
+}
+
+//==============================================================================================================================
+// Compares two trees child by child. A changed node is reported once, its descendants are compared too unless its kind or name
+// changed, then it counts as another sub-tree. Children past the end of the shorter child list are added or removed.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void diffTrees( const node_i< timeData_t >& cA, const node_i< timeData_t >& cB, const std::string& cPath,
+                       std::vector< treeChange_t >& changes ) {
+    if ( cA.mcKind != cB.mcKind || cA.mcName != cB.mcName ) {
+        changes.emplace_back( treeChange_t { change_t::CHANGED, cPath } );
+        return;
+    }
+    if ( structuralParams( cA ) != structuralParams( cB ) ) {
+        changes.emplace_back( treeChange_t { change_t::CHANGED, cPath } );
+    }
+
+    const auto& cChildrenA = cA.mcGetChildren();
+    const auto& cChildrenB = cB.mcGetChildren();
+
+    for ( size_t iChild = 0; iChild < std::max( cChildrenA.size(), cChildrenB.size() ); ++iChild ) {
+        if ( iChild >= cChildrenB.size() ) {
+            changes.emplace_back( treeChange_t { change_t::REMOVED, cPath + "/" + cChildrenA[ iChild ]->mcName } );
+        } else if ( iChild >= cChildrenA.size() ) {
+            changes.emplace_back( treeChange_t { change_t::ADDED, cPath + "/" + cChildrenB[ iChild ]->mcName } );
+        } else {
+            diffTrees( *cChildrenA[ iChild ], *cChildrenB[ iChild ], cPath + "/" + cChildrenA[ iChild ]->mcName, changes );
+        }
+    }
+}
+
+//==============================================================================================================================
+// Returns no changes for structurally identical trees.
+//==============================================================================================================================
+template< typename timeData_t >
+inline std::vector< treeChange_t > diffTrees( const node_i< timeData_t >& cA, const node_i< timeData_t >& cB ) {
+    std::vector< treeChange_t > changes;
+    diffTrees( cA, cB, cA.mcName, changes );
+
+    return changes;
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,116 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+#include "parentnode_i.hpp"
+#include "tree_c.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// Splices a sub-tree owned by another tree. The other tree is shared and immutable, it lives as long as any tree that splices
+// it, and its root becomes the only child of this node. Passes that restructure a tree must not descend into this node.
+// The node's state is the whole state of the other tree, so the spliced nodes tick relative to it.
+//==============================================================================================================================
+template< typename timeData_t >
+class subtreeNode_c final : public parentNode_i< timeData_t > {
+    using parentNode_t = parentNode_i< timeData_t >;
+    using context_t    = typename parentNode_t::context_t;
+    using node_t       = node_i< timeData_t >;
+    using treePtr_t    = std::shared_ptr< const tree_c< timeData_t > >;
+
+public:
+    inline status_t mTick( context_t& context )                  const noexcept override;
+    inline uint32_t mcGetResumeChild( const context_t& cContext ) const noexcept override;
+
+    inline const tree_c< timeData_t >& mcGetTree( void ) const noexcept;
+
+    subtreeNode_c&  operator=( const subtreeNode_c& ) = delete;
+    subtreeNode_c&  operator=( subtreeNode_c&& )      noexcept = delete;
+    explicit inline subtreeNode_c( treePtr_t pTree );
+    inline          subtreeNode_c( const subtreeNode_c& cNode );
+    inline          subtreeNode_c( subtreeNode_c&& node );
+                    ~subtreeNode_c( void )            = default;
+
+private:
+    const treePtr_t mcpTree; // Tree that owns the spliced nodes.
+
+    using parentNode_t::mChildren;
+};
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t subtreeNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    uint8_t* const cpState { context.pState };
+
+    context.pState += parentNode_t::mcGetStateOffset();
+    const status_t cStatus { mChildren.front()->mTick( context ) };
+    context.pState = cpState;
+
+    return cStatus;
+}
+
+//==============================================================================================================================
+// A resumed tick continues in the spliced root, relative to the state of this node.
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t subtreeNode_c< timeData_t >::mcGetResumeChild( const context_t& ) const noexcept {
+    return 0;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto subtreeNode_c< timeData_t >::mcGetTree( void ) const noexcept ->const tree_c< timeData_t >& {
+    return *mcpTree;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline subtreeNode_c< timeData_t >::subtreeNode_c( treePtr_t pTree ) :
+    parentNode_t( nodeKind_t::SUBTREE, pTree ? pTree->mcGetRoot()->mcName : std::string_view(), 1, pTree ? pTree->mcGetStateSize() : 0 ),
+    mcpTree( move( pTree ) ) {
+    if ( !mcpTree ) {
+        SMD_FBT_THROW( "Can't splice an empty sub-tree." );
+    }
+
+    parentNode_t::mAddChild( const_cast< node_t* >( mcpTree->mcGetRoot() ) );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline subtreeNode_c< timeData_t >::subtreeNode_c( const subtreeNode_c& cNode ) :
+    parentNode_t( cNode ),
+    mcpTree( cNode.mcpTree ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline subtreeNode_c< timeData_t >::subtreeNode_c( subtreeNode_c&& node ) :
+    parentNode_t( std::move( node ) ),
+    mcpTree( node.mcpTree ) {}
+
+} // namespace smd::fbt
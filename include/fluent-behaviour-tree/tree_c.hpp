@@ -0,0 +1,726 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+#pragma once
+
+#include "common.hpp"
+#include "activepath_c.hpp"
+#include "conditionnode_c.hpp"
+#include "node_i.hpp"
+#include "parentnode_i.hpp"
+#include "snapshot.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// A built behaviour tree. The tree owns all of its nodes, parents reference their children by plain pointers, so destroying
+// the tree just destroys the nodes one by one without any reference counting. Sub-trees spliced from other trees are shared
+// explicitly by 'subtreeNode_c'. Nodes don't change while ticking, the dynamic state lives in a separate zero-initialised
+// block, the tree keeps one for its own 'mTick' and every 'instance_c' of the tree has another.
+//
+// The tree may be edited after it's built by the 'm...Child' methods. Edits don't lay out the state block again, the state of
+// new nodes is appended and only the slots of the edited parents are reset, so agents keep the state of the rest of the tree.
+// Every edit makes a new revision, 'mcUpdateState' brings a state block of an older revision up to date. The state of removed
+// nodes stays unused until 'mCompact', which lays out the block from scratch and resets the state of all instances.
+//
+// Nodes are found without walking the tree by their ids, by their paths like "agent/patrol/walk", or by their names. The
+// indices are built when the root is set and kept up to date by the edits. Paths end at spliced sub-trees, the nodes of a
+// sub-tree are found in its own tree.
+//
+// A tree that shares guards evaluates every shared condition name at most once per tick, e.g. "has-target" tested by several
+// branches of a selector. Shared conditions of the same name share a slot of the state, and every tick of the tree stamps a
+// new epoch in the state, so a cached result is only read within the tick it was evaluated in. Functions can't be compared, so
+// conditions are shared only when created by 'builder_c::mSharedCondition', which tells that the name identifies the test.
+//==============================================================================================================================
+template< typename timeData_t >
+class tree_c final {
+    using node_t       = node_i< timeData_t >;
+    using parentNode_t = parentNode_i< timeData_t >;
+    using context_t    = tickContext_t< timeData_t >;
+
+public:
+    template< typename node_tt, typename... args_tt >
+    inline node_tt* mCreate( args_tt&&... args );
+    inline void     mSetRoot( node_t* pRoot );
+    inline status_t mTick( param_t< timeData_t > timeData, profiler_c* pProfiler = nullptr ) noexcept;
+    inline void     mSetMemory( bool hasMemory )                                             noexcept; // See 'activePath_c'.
+    inline void     mSetGuardSharing( bool isShared );                                                 // Resets the state.
+    inline void     mcStampTick( context_t& context )                                  const noexcept; // Sets the epoch.
+
+    inline status_t mTick( param_t< timeData_t > timeData, const tickBudget_t& cBudget, profiler_c* pProfiler = nullptr ) noexcept;
+
+    inline void mInsertChild( parentNode_t& parent, size_t iChild, node_t* pChild );  // The child is created by 'mCreate'.
+    inline void mRemoveChild( parentNode_t& parent, size_t iChild );                   // Destroys the removed nodes.
+    inline void mReplaceChild( parentNode_t& parent, size_t iChild, node_t* pChild ); // Destroys the replaced nodes.
+    inline void mMoveChild( parentNode_t& parent, size_t iFrom, size_t iTo );
+    inline void mCompact( void );
+
+    inline size_t mDestroyDetached( void ); // Returns the number of destroyed nodes.
+
+    template< typename allocator_t >
+    inline void mcUpdateState( std::vector< stateWord_t, allocator_t >& state, uint32_t revision ) const;
+
+    inline node_t*       mGetRoot( void );
+    inline const node_t* mcGetRoot( void )                      const noexcept;
+    inline node_t*       mGetNode( uint32_t id )                      noexcept; // Or null if there is no such node.
+    inline const node_t* mcGetNode( uint32_t id )               const noexcept;
+    inline node_t*       mFind( std::string_view cPath )              noexcept; // Or null if there is no such path.
+    inline const node_t* mcFind( std::string_view cPath )       const noexcept;
+    inline const node_t* mcFindByName( std::string_view cName ) const noexcept; // The first node with the name.
+    inline size_t        mcGetNumNodes( void )                  const noexcept;
+    inline uint32_t      mcGetStateSize( void )                 const noexcept; // Bytes of state an instance needs.
+    inline uint32_t      mcGetRevision( void )                  const noexcept; // Changes with every edit.
+    inline bool          mcIsCompact( void )                    const noexcept; // Whether laid out with no edits since.
+    inline bool          mcHasMemory( void )                    const noexcept;
+    inline bool          mcSharesGuards( void )                 const noexcept;
+    inline bool          mcIsSuspended( void )                  const noexcept; // Whether the last tick ran out of budget.
+
+    tree_c& operator=( const tree_c& ) = delete;
+    tree_c& operator=( tree_c&& )      noexcept = default;
+            tree_c( void )             = default;
+            tree_c( const tree_c& )    = delete;
+            tree_c( tree_c&& )         noexcept = default;
+            ~tree_c( void )            = default;
+
+private:
+    struct dirtySlot_t final {
+        uint32_t revision; // Revision the slot was reset in.
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct guard_t final {
+        uint32_t numUses; // Shared conditions of the name reachable from the root.
+        uint32_t offset;  // Slot of the result once the name is used twice, 'cNoGuard' before.
+    };
+
+    using index_t = std::unordered_multimap< std::string_view, node_t* >;
+
+    inline void mLayOutState( void );
+    inline void mAppendState( node_t* pNode );
+    inline void mShareGuards( node_t& subtree );
+    inline void mDestroy( node_t* pNode );
+    inline void mEdited( parentNode_t& parent, node_t* pAdded );
+    inline void mIndex( node_t& subtree, const std::string* cpParentPath );
+    inline void mcCheckEdit( const parentNode_t& cParent, const node_t* cpChild ) const;
+
+    inline bool    mcOwns( const node_t* cpNode ) const noexcept;
+
+    inline node_t* mcFindFirst( const index_t& cIndex, std::string_view cKey ) const noexcept;
+
+    std::vector< std::unique_ptr< node_t > >         mNodes;                      // All nodes by ids, null for removed nodes.
+    size_t                                           mNumNodes { 0 };             // Nodes not removed.
+    node_t*                                          mpRoot { nullptr };          // Node to start ticking from.
+    uint32_t                                         mStateSize { 0 };            // Size of the state block of an instance.
+    std::vector< stateWord_t >                       mState;                      // State of the instance ticked by 'mTick'.
+    uint32_t                                         mRevision { 0 };             // Current revision.
+    uint32_t                                         mLayoutRevision { 0 };       // Revision the state block was laid out in.
+    std::vector< dirtySlot_t >                       mDirtySlots;                 // Slots reset by the edits since the layout.
+    std::unordered_map< const node_t*, std::string > mPaths;                      // Paths of the nodes reachable from the root.
+    index_t                                          mByPath;                     // Views of 'mPaths'.
+    index_t                                          mByName;                     // Views of the names of the nodes.
+    std::unordered_set< const node_t* >              mDetached;                   // Nodes not reachable from the root.
+    bool                                             mHasMemory { false };        // Whether ticks resume at the running leaf.
+    bool                                             mSharesGuards { false };     // Whether same-named conditions share results.
+    uint32_t                                         mEpochOffset { UINT32_MAX }; // Epoch of the last tick in the state, if shared.
+    std::unordered_map< std::string, guard_t >       mGuards;                     // Shared conditions by name, if shared.
+    activePath_c< timeData_t >                       mPath;                       // Running path of 'mState'.
+};
+
+//==============================================================================================================================
+// Creates a node owned by the tree, it lives as long as the tree.
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename node_tt, typename... args_tt >
+inline node_tt* tree_c< timeData_t >::mCreate( args_tt&&... args ) {
+    auto pNode = std::make_unique< node_tt >( std::forward< args_tt >( args )... );
+
+    node_tt* const cpNode { pNode.get() };
+    cpNode->mSetId( static_cast< uint32_t >( mNodes.size() ) );
+    mNodes.emplace_back( move( pNode ) );
+    mDetached.emplace( cpNode );
+    ++mNumNodes;
+
+    return cpNode;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mSetRoot( node_t* pRoot ) {
+    if ( !pRoot ) {
+        SMD_FBT_THROW( "Can't create a behaviour tree with zero nodes" );
+    }
+
+    mpRoot = pRoot;
+    ++mRevision;
+    mPaths.clear();
+    mByPath.clear();
+    mByName.clear();
+    mDetached.clear();
+
+    for ( const auto& cpNode : mNodes ) {
+        if ( cpNode ) {
+            mDetached.emplace( cpNode.get() );
+        }
+    }
+
+    mIndex( *mpRoot, nullptr );
+    mLayOutState();
+}
+
+//==============================================================================================================================
+// Ticks the tree with its own state. Trees shared between agents are ticked through an 'instance_c' per agent instead.
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t tree_c< timeData_t >::mTick( param_t< timeData_t > timeData, profiler_c* pProfiler ) noexcept {
+    const profileSpan_c cSpan( pProfiler, mpRoot->mcName, "tree" );
+
+    context_t            context { timeData, reinterpret_cast< uint8_t* >( mState.data() ), pProfiler };
+    const scratchScope_c cScratch( context.pScratch );
+
+    mcStampTick( context );
+
+    return mHasMemory || mPath.mcIsSuspended() ? mPath.mTick( *mpRoot, context, mHasMemory ) : mpRoot->mTick( context );
+}
+
+//==============================================================================================================================
+// A time-sliced tick like 'instance_c::mTick', with the tree's own state.
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t tree_c< timeData_t >::mTick( param_t< timeData_t > timeData, const tickBudget_t& cBudget,
+                                           profiler_c* pProfiler ) noexcept {
+    const profileSpan_c cSpan( pProfiler, mpRoot->mcName, "tree" );
+
+    tickSlice_t< timeData_t > slice { startSlice< timeData_t >( cBudget ) };
+    context_t                 context { timeData, reinterpret_cast< uint8_t* >( mState.data() ), pProfiler };
+    const scratchScope_c      cScratch( context.pScratch );
+
+    context.pSlice = &slice;
+    mcStampTick( context );
+
+    return mPath.mTick( *mpRoot, context, mHasMemory );
+}
+
+//==============================================================================================================================
+// With memory a tick resumes right at the running leaf, for the tree's own 'mTick' and its instances. Without memory (the
+// default) every tick starts at the root, the composites just know which child was running. Set it before the tree is shared.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mSetMemory( bool hasMemory ) noexcept {
+    mHasMemory = hasMemory;
+    mPath.mInvalidate();
+}
+
+//==============================================================================================================================
+// Lays out the state again, so the state of instances is reset. Set it before the tree is shared, like the memory.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mSetGuardSharing( bool isShared ) {
+    mSharesGuards = isShared;
+    ++mRevision;
+    mLayOutState();
+}
+
+//==============================================================================================================================
+// Starts a new epoch for the shared guards at the root of a tick, 'context.pState' must point at the state of this tree. The
+// epoch is kept in the state, so it goes along with snapshots and restores.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mcStampTick( context_t& context ) const noexcept {
+    if ( !mSharesGuards ) {
+        return;
+    }
+
+    std::memcpy( &context.epoch, context.pState + mEpochOffset, sizeof( uint64_t ) );
+    ++context.epoch;
+    std::memcpy( context.pState + mEpochOffset, &context.epoch, sizeof( uint64_t ) );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mInsertChild( parentNode_t& parent, size_t iChild, node_t* pChild ) {
+    mcCheckEdit( parent, pChild );
+
+    if ( iChild > parent.mcGetNumChildren() || parent.mcIsFull() ) {
+        mDestroy( pChild );
+        SMD_FBT_THROW( "Can't insert a child past the end of the children or into a full node, the child is destroyed." );
+    }
+
+    parent.mInsertChild( iChild, pChild );
+    mAppendState( pChild );
+    mEdited( parent, pChild );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mRemoveChild( parentNode_t& parent, size_t iChild ) {
+    mDestroy( parent.mRemoveChild( iChild ) );
+    mEdited( parent, nullptr );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mReplaceChild( parentNode_t& parent, size_t iChild, node_t* pChild ) {
+    mcCheckEdit( parent, pChild );
+
+    if ( iChild >= parent.mcGetNumChildren() ) {
+        mDestroy( pChild );
+        SMD_FBT_THROW( "Can't replace a child that doesn't exist, the new child is destroyed." );
+    }
+
+    mDestroy( parent.mReplaceChild( iChild, pChild ) );
+    mAppendState( pChild );
+    mEdited( parent, pChild );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mMoveChild( parentNode_t& parent, size_t iFrom, size_t iTo ) {
+    if ( iFrom >= parent.mcGetChildren().size() || iTo >= parent.mcGetChildren().size() ) {
+        SMD_FBT_THROW( "Can't move a child from or to a position that doesn't exist." );
+    }
+
+    auto children = parent.mcGetChildren();
+    node_t* const cpChild { children[ iFrom ] };
+
+    children.erase( children.begin() + iFrom );
+    children.insert( children.begin() + iTo, cpChild );
+    parent.mSetChildren( move( children ) );
+    mEdited( parent, nullptr );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mCompact( void ) {
+    ++mRevision;
+    mLayOutState();
+}
+
+//==============================================================================================================================
+// Destroys the nodes not reachable from the root, e.g. dropped by 'optimizer_c' or by a new root, together with any nodes made
+// by 'mCreate' and not attached yet. Detached nodes have no state nor paths, and they only point to each other or to nodes that
+// stay, so each one is destroyed alone.
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t tree_c< timeData_t >::mDestroyDetached( void ) {
+    const size_t cNumDestroyed { mDetached.size() };
+
+    for ( const node_t* const cpNode : mDetached ) {
+        mNodes[ cpNode->mcGetId() ].reset();
+    }
+
+    mDetached.clear();
+    mNumNodes -= cNumDestroyed;
+
+    return cNumDestroyed;
+}
+
+//==============================================================================================================================
+// The block must have been laid out by this tree in the given revision, or be empty with the revision zero.
+//==============================================================================================================================
+template< typename timeData_t >
+template< typename allocator_t >
+inline void tree_c< timeData_t >::mcUpdateState( std::vector< stateWord_t, allocator_t >& state, uint32_t revision ) const {
+    const size_t cNumWords { ( mStateSize + sizeof( stateWord_t ) - 1 ) / sizeof( stateWord_t ) };
+
+    if ( revision < mLayoutRevision ) {
+        state.assign( cNumWords, 0 );
+        return;
+    }
+
+    state.resize( cNumWords, 0 );
+
+    for ( const dirtySlot_t& cSlot : mDirtySlots ) {
+        if ( cSlot.revision > revision ) {
+            std::memset( reinterpret_cast< uint8_t* >( state.data() ) + cSlot.offset, 0, cSlot.size );
+        }
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mGetRoot( void ) ->node_t* {
+    return mpRoot;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mcGetRoot( void ) const noexcept ->const node_t* {
+    return mpRoot;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mGetNode( uint32_t id ) noexcept ->node_t* {
+    return id < mNodes.size() ? mNodes[ id ].get() : nullptr;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mcGetNode( uint32_t id ) const noexcept ->const node_t* {
+    return id < mNodes.size() ? mNodes[ id ].get() : nullptr;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mFind( std::string_view cPath ) noexcept ->node_t* {
+    return mcFindFirst( mByPath, cPath );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mcFind( std::string_view cPath ) const noexcept ->const node_t* {
+    return mcFindFirst( mByPath, cPath );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mcFindByName( std::string_view cName ) const noexcept ->const node_t* {
+    return mcFindFirst( mByName, cName );
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline size_t tree_c< timeData_t >::mcGetNumNodes( void ) const noexcept {
+    return mNumNodes;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t tree_c< timeData_t >::mcGetStateSize( void ) const noexcept {
+    return mStateSize;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline uint32_t tree_c< timeData_t >::mcGetRevision( void ) const noexcept {
+    return mRevision;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool tree_c< timeData_t >::mcHasMemory( void ) const noexcept {
+    return mHasMemory;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool tree_c< timeData_t >::mcSharesGuards( void ) const noexcept {
+    return mSharesGuards;
+}
+
+//==============================================================================================================================
+// A compact tree lays out its state like a tree built with the same structure, an edited one only after 'mCompact'.
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool tree_c< timeData_t >::mcIsCompact( void ) const noexcept {
+    return mRevision == mLayoutRevision;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool tree_c< timeData_t >::mcIsSuspended( void ) const noexcept {
+    return mPath.mcIsSuspended();
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mLayOutState( void ) {
+    mStateSize      = 0;
+    mLayoutRevision = mRevision;
+    mDirtySlots.clear();
+    mGuards.clear();
+    mEpochOffset    = UINT32_MAX;
+
+    mAppendState( mpRoot );
+    mShareGuards( *mpRoot );
+    mState.assign( ( mStateSize + sizeof( stateWord_t ) - 1 ) / sizeof( stateWord_t ), 0 );
+    mPath.mInvalidate();
+}
+
+//==============================================================================================================================
+// Gives every stateful node of the sub-tree its own aligned slice after the end of the state block. A sub-tree node takes a
+// slice as big as the whole state of its tree, the spliced nodes keep the offsets their own tree gave them.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mAppendState( node_t* pNode ) {
+    constexpr uint32_t cAlign { node_t::cStateAlign };
+
+    pNode->mVisit( [ this ]( node_t& node, uint32_t ) {
+        if ( node.mcStateSize > 0 ) {
+            mStateSize = ( mStateSize + cAlign - 1 ) / cAlign * cAlign;
+            node.mSetStateOffset( mStateSize );
+            mStateSize += node.mcStateSize;
+        }
+
+        return node.mcKind != nodeKind_t::SUBTREE;
+    } );
+}
+
+//==============================================================================================================================
+// Counts the shared conditions of a sub-tree just laid out or inserted, and gives every name now used more than once a slot
+// after the end of the state block, and the epoch a slot of its own the first time. Names shared once stay shared, so edits
+// only append the slots of new names. Only the sub-tree and the other conditions of its names are visited.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mShareGuards( node_t& subtree ) {
+    using conditionNode_t = conditionNode_c< timeData_t >;
+    using result_t        = typename conditionNode_t::guard_t;
+
+    constexpr uint32_t cAlign { node_t::cStateAlign };
+
+    auto isShared = []( const node_t& cNode ) {
+        return cNode.mcKind == nodeKind_t::CONDITION && static_cast< const conditionNode_t& >( cNode ).mcIsShared;
+    };
+
+    if ( !mSharesGuards ) {
+        subtree.mVisit( []( node_t& node, uint32_t ) {
+            if ( node.mcKind == nodeKind_t::CONDITION ) {
+                static_cast< conditionNode_t& >( node ).mSetGuardOffset( conditionNode_t::cNoGuard );
+            }
+
+            return node.mcKind != nodeKind_t::SUBTREE;
+        } );
+
+        return;
+    }
+
+    auto append = [ this ]( uint32_t size ) {
+        mStateSize = ( mStateSize + cAlign - 1 ) / cAlign * cAlign;
+        mStateSize += size;
+
+        return mStateSize - size;
+    };
+
+    if ( mEpochOffset == UINT32_MAX ) {
+        mEpochOffset = append( sizeof( uint64_t ) );
+    }
+
+    std::vector< guard_t* > added; // Guards of the names used by the sub-tree.
+
+    subtree.mVisit( [ this, &isShared, &added ]( node_t& node, uint32_t ) {
+        if ( isShared( node ) ) {
+            guard_t& guard { mGuards.try_emplace( node.mcName, guard_t { 0, conditionNode_t::cNoGuard } ).first->second };
+
+            ++guard.numUses;
+            added.emplace_back( &guard );
+        }
+
+        return node.mcKind != nodeKind_t::SUBTREE;
+    } );
+
+    for ( guard_t* pGuard : added ) {
+        if ( pGuard->numUses < 2 || pGuard->offset != conditionNode_t::cNoGuard ) {
+            continue;
+        }
+
+        pGuard->offset = append( sizeof( result_t ) );
+    }
+
+    // A name given a slot just now may be used outside of the sub-tree too, those conditions are found by the name.
+    subtree.mVisit( [ this, &isShared ]( node_t& node, uint32_t ) {
+        if ( node.mcKind == nodeKind_t::CONDITION ) {
+            const auto     cIt = isShared( node ) ? mGuards.find( node.mcName ) : mGuards.end();
+            const uint32_t cOffset { cIt != mGuards.end() ? cIt->second.offset : conditionNode_t::cNoGuard };
+
+            if ( cIt != mGuards.end() && static_cast< conditionNode_t& >( node ).mcGetGuardOffset() != cOffset ) {
+                const auto [ cBegin, cEnd ] = mByName.equal_range( node.mcName );
+
+                for ( auto it = cBegin; it != cEnd; ++it ) {
+                    if ( isShared( *it->second ) ) {
+                        static_cast< conditionNode_t& >( *it->second ).mSetGuardOffset( cOffset );
+                    }
+                }
+            }
+
+            static_cast< conditionNode_t& >( node ).mSetGuardOffset( cOffset );
+        }
+
+        return node.mcKind != nodeKind_t::SUBTREE;
+    } );
+}
+
+//==============================================================================================================================
+// Destroys a node removed from the tree with all of its descendants, the nodes of spliced sub-trees belong to other trees. The
+// removed nodes that were reachable from the root leave the indices, and the counts of the shared guards.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mDestroy( node_t* pNode ) {
+    using conditionNode_t = conditionNode_c< timeData_t >;
+
+    auto erase = []( index_t& index, std::string_view cKey, const node_t* cpNode ) {
+        const auto [ cBegin, cEnd ] = index.equal_range( cKey );
+
+        for ( auto it = cBegin; it != cEnd; ++it ) {
+            if ( it->second == cpNode ) {
+                index.erase( it );
+                return;
+            }
+        }
+    };
+
+    std::vector< uint32_t > removed;
+
+    pNode->mVisit( [ this, &removed, &erase ]( node_t& node, uint32_t ) {
+        removed.emplace_back( node.mcGetId() );
+        mDetached.erase( &node );
+
+        const auto cPath = mPaths.find( &node );
+
+        if ( cPath == mPaths.end() ) {
+            return node.mcKind != nodeKind_t::SUBTREE;
+        }
+
+        erase( mByPath, cPath->second, &node );
+        erase( mByName, node.mcName, &node );
+        mPaths.erase( cPath );
+
+        if ( mSharesGuards && node.mcKind == nodeKind_t::CONDITION && static_cast< conditionNode_t& >( node ).mcIsShared ) {
+            if ( const auto cIt = mGuards.find( node.mcName ); cIt != mGuards.end() ) {
+                --cIt->second.numUses;
+            }
+        }
+
+        return node.mcKind != nodeKind_t::SUBTREE;
+    } );
+
+    for ( const uint32_t cId : removed ) {
+        mNodes[ cId ].reset();
+    }
+
+    mNumNodes -= removed.size();
+}
+
+//==============================================================================================================================
+// The children of the parent changed, so its state (e.g. the index of the running child) is no longer valid. An added sub-tree
+// is indexed under the parent and its shared conditions get their guards.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mEdited( parentNode_t& parent, node_t* pAdded ) {
+    const uint32_t cRevision { mRevision++ };
+
+    if ( parent.mcStateSize > 0 ) {
+        mDirtySlots.emplace_back( dirtySlot_t { mRevision, parent.mcGetStateOffset(), parent.mcStateSize } );
+    }
+
+    if ( const auto cIt = mPaths.find( &parent ); pAdded && cIt != mPaths.end() ) {
+        mIndex( *pAdded, &cIt->second );
+        mShareGuards( *pAdded );
+    }
+
+    mcUpdateState( mState, cRevision );
+    mPath.mInvalidate();
+}
+
+//==============================================================================================================================
+// Indexes the paths and names of a sub-tree under the path of its parent, or as the root without one. 'mPaths' keeps the
+// strings at stable addresses, so the path index holds views of them.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mIndex( node_t& subtree, const std::string* cpParentPath ) {
+    std::vector< const std::string* > parents; // Path of the last node visited at each depth.
+
+    subtree.mVisit( [ this, cpParentPath, &parents ]( node_t& node, uint32_t depth ) {
+        const std::string* const cpParent { depth == 0 ? cpParentPath : parents[ depth - 1 ] };
+        std::string&             path { mPaths[ &node ] };
+
+        path = cpParent ? *cpParent + '/' + node.mcName : node.mcName;
+
+        parents.resize( depth );
+        parents.emplace_back( &path );
+        mDetached.erase( &node );
+        mByPath.emplace( path, &node );
+        mByName.emplace( node.mcName, &node );
+
+        return node.mcKind != nodeKind_t::SUBTREE;
+    } );
+}
+
+//==============================================================================================================================
+// An edit attaches a node of this tree that has no parent yet, e.g. one just made by 'mCreate'. Nodes reachable from the root
+// have a parent, or are the root, and only the few detached nodes need to be searched for another parent. Spliced sub-trees
+// belong to other trees, so the walk ends at them.
+//==============================================================================================================================
+template< typename timeData_t >
+inline void tree_c< timeData_t >::mcCheckEdit( const parentNode_t& cParent, const node_t* cpChild ) const {
+    if ( !cpChild ) {
+        SMD_FBT_THROW( "Can't add an empty child." );
+    }
+    if ( !mcOwns( &cParent ) || !mcOwns( cpChild ) ) {
+        SMD_FBT_THROW( "Can't edit the children with nodes created by another tree." );
+    }
+
+    bool isValid { true };
+
+    cpChild->mcVisit( [ this, &cParent, &isValid ]( const node_t& cNode, uint32_t ) {
+        isValid = isValid && &cNode != &cParent && mcOwns( &cNode ) && !mPaths.count( &cNode );
+        return isValid && cNode.mcKind != nodeKind_t::SUBTREE;
+    } );
+
+    for ( const node_t* const cpNode : mDetached ) {
+        const auto& cChildren { cpNode->mcGetChildren() };
+        isValid = isValid && std::find( cChildren.begin(), cChildren.end(), cpChild ) == cChildren.end();
+    }
+
+    if ( !isValid ) {
+        SMD_FBT_THROW( "Can't add a child that already has a parent or is an ancestor of the parent." );
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline bool tree_c< timeData_t >::mcOwns( const node_t* cpNode ) const noexcept {
+    const uint32_t cId { cpNode->mcGetId() };
+    return cId < mNodes.size() && mNodes[ cId ].get() == cpNode;
+}
+
+//==============================================================================================================================
+// Of several nodes with the same path or name the first one in pre-order wins. The indices are updated by edits in any order,
+// so only then the tree is walked to find it.
+//==============================================================================================================================
+template< typename timeData_t >
+inline auto tree_c< timeData_t >::mcFindFirst( const index_t& cIndex, std::string_view cKey ) const noexcept ->node_t* {
+    const auto [ cBegin, cEnd ] = cIndex.equal_range( cKey );
+
+    if ( cBegin == cEnd || std::next( cBegin ) == cEnd ) {
+        return cBegin != cEnd ? cBegin->second : nullptr;
+    }
+
+    node_t* pFirst { nullptr };
+
+    mpRoot->mcVisit( [ &pFirst, cBegin = cBegin, cEnd = cEnd ]( const node_t& cNode, uint32_t ) {
+        for ( auto it = cBegin; !pFirst && it != cEnd; ++it ) {
+            if ( it->second == &cNode ) {
+                pFirst = it->second;
+            }
+        }
+
+        return !pFirst && cNode.mcKind != nodeKind_t::SUBTREE;
+    } );
+
+    return pFirst;
+}
+
+} // namespace smd::fbt
@@ -0,0 +1,92 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+#pragma once
+
+#include "common.hpp"
+#include "node_i.hpp"
+
+namespace smd::fbt {
+
+//==============================================================================================================================
+// A behaviour tree leaf node that waits for an event. It returns RUNNING and asks for the instance to sleep until the event,
+// then succeeds on the tick the event wakes the instance up for. A 'scheduler_c' doesn't tick sleeping instances at all,
+// ticked without one the node just keeps running. Events signalled before the node waits for them are not remembered.
+// The state tells whether the node is waiting, so a zeroed state means it hasn't been ticked yet.
+//==============================================================================================================================
+template< typename timeData_t >
+class waitNode_c final : public node_i< timeData_t > {
+    using node_t    = node_i< timeData_t >;
+    using context_t = typename node_t::context_t;
+
+public:
+    const uint32_t mcEvent; // Event to wait for.
+
+    inline status_t mTick( context_t& context ) const noexcept override;
+
+    waitNode_c& operator=( const waitNode_c& ) = delete;
+    waitNode_c& operator=( waitNode_c&& )      noexcept = delete;
+    inline      waitNode_c( std::string_view cName, uint32_t event );
+    inline      waitNode_c( const waitNode_c& cNode );
+    inline      waitNode_c( waitNode_c&& node );
+                ~waitNode_c( void ) = default;
+};
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline status_t waitNode_c< timeData_t >::mTick( context_t& context ) const noexcept {
+    if ( context.wakeEvent == mcEvent && this->template mcLoadState< uint32_t >( context ) ) {
+        this->mcStoreState( context, 0u );
+        return status_t::SUCCESS;
+    }
+
+    this->mcStoreState( context, 1u );
+    context.waitEvent = mcEvent;
+
+    return status_t::RUNNING;
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline waitNode_c< timeData_t >::waitNode_c( std::string_view cName, uint32_t event ) :
+    node_t( nodeKind_t::WAIT, cName, sizeof( uint32_t ) ),
+    mcEvent( event ) {
+    if ( event == cNoEvent ) {
+        SMD_FBT_THROW( "Can't wait for 'cNoEvent'." );
+    }
+}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline waitNode_c< timeData_t >::waitNode_c( const waitNode_c& cNode ) :
+    node_t( cNode ),
+    mcEvent( cNode.mcEvent ) {}
+
+//==============================================================================================================================
+template< typename timeData_t >
+inline waitNode_c< timeData_t >::waitNode_c( waitNode_c&& node ) :
+    node_t( std::move( node ) ),
+    mcEvent( node.mcEvent ) {}
+
+} // namespace smd::fbt
@@ -0,0 +1,66 @@
+//==============================================================================================================================
+//
+// This file is part of the sam0delk1n's Conventional Tools (smdCT).
+//
+// Copyright © 2018 sam0delk1n <skipper05ster@gmail.com>.
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+//==============================================================================================================================
+
+// Builds with '-fno-exceptions' to check that the library doesn't depend on exceptions.
+
+#include "../include/fluent-behaviour-tree.hpp"
+
+#include <iostream>
+
+using namespace std;
+using namespace smd::fbt;
+
+using timeData_t = float;
+using builder_t  = builder_c< timeData_t >;
+
+//==============================================================================================================================
+int main( void ) {
+    builder_t builder;
+
+    auto pTree = builder
+        .mSelector( "some-selector" )
+            .mInverter( "some-inverter" )
+                .mCondition( "some-condition", []( timeData_t timeData ) { return timeData < 0.2f; } )
+            .mEnd()
+            .mSequence( "some-sequence" )
+                .mDo( "some-action", []( timeData_t ) { return status_t::RUNNING; } )
+            .mEnd()
+        .mEnd()
+        .mBuild();
+
+    // The macro must be a single statement, like the 'throw' it stands for.
+    if ( !pTree )
+        SMD_FBT_THROW( "Can't build the tree." );
+    else
+        pTree->mSetMemory( false );
+
+    if ( status_t::RUNNING != pTree->mTick( 0.1f ) || status_t::SUCCESS != pTree->mTick( 0.3f ) ) {
+        cerr << "fbt-noexcept-check: FAILED" << endl;
+        return 1;
+    }
+
+    cout << "fbt-noexcept-check: PASSED" << endl;
+    return 0;
+}
@@ -0,0 +1,45 @@
+// Generated by 'smd::fbt::codegen_c' from the tree "agent", don't edit.
+
+#pragma once
+
+#include "../include/fluent-behaviour-tree.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+template< typename timeData_t, typename leaves_t >
+inline smd::fbt::status_t tickGeneratedTree( leaves_t& leaves, smd::fbt::param_t< timeData_t > timeData ) noexcept {
+    using smd::fbt::status_t;
+
+    status_t status;
+
+    do { // "agent"
+        do { // "attack"
+            status = leaves( std::integral_constant< size_t, 0 >(), timeData ) ? status_t::SUCCESS : status_t::FAILURE; // "is-enemy-visible"
+            if ( status != status_t::SUCCESS ) break;
+            status = leaves( std::integral_constant< size_t, 1 >(), timeData ); // "shoot"
+        } while ( false );
+        if ( status != status_t::FAILURE ) break;
+        { // "idle"
+            uint32_t numSucceeded0 { 0 };
+            uint32_t numFailed0 { 0 };
+            status = leaves( std::integral_constant< size_t, 2 >(), timeData ); // "patrol"
+            numSucceeded0 += status == status_t::SUCCESS;
+            numFailed0 += status == status_t::FAILURE;
+            status = leaves( std::integral_constant< size_t, 3 >(), timeData ) ? status_t::SUCCESS : status_t::FAILURE; // "is-tired"
+            status = smd::fbt::invertStatus( status ); // "is-rested"
+            numSucceeded0 += status == status_t::SUCCESS;
+            numFailed0 += status == status_t::FAILURE;
+            status = numSucceeded0 >= 1 ? status_t::SUCCESS : numFailed0 >= 2 ? status_t::FAILURE : status_t::RUNNING;
+        }
+    } while ( false );
+
+    return status;
+}
+
+constexpr const char* tickGeneratedTreeLeaves[] {
+    "is-enemy-visible",
+    "shoot",
+    "patrol",
+    "is-tired",
+};
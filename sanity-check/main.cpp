@@ -24,12 +24,20 @@
 //==============================================================================================================================
 
 #include "../include/fluent-behaviour-tree.hpp"
+#include "generated-tree.hpp"
 
+#include <chrono>
+#include <fstream>
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
 #include <string>
 #include <exception>
+#include <vector>
 
 #define SMD_CHK_EXCEPT_CT( statement ) { \
     bool caught { false };               \
@@ -62,7 +70,63 @@ using parallelNode_t = parallelNode_c< timeData_t >;
 using selectorNode_t = selectorNode_c< timeData_t >;
 using sequenceNode_t = sequenceNode_c< timeData_t >;
 using builder_t      = builder_c< timeData_t >;
-using nodePtr_t      = shared_ptr< node_i< timeData_t > >;
+using optimizer_t    = optimizer_c< timeData_t >;
+using nodePtr_t      = unique_ptr< node_i< timeData_t > >;
+using tree_t         = tree_c< timeData_t >;
+using instance_t     = instance_c< timeData_t >;
+using library_t      = library_c< timeData_t >;
+
+//==============================================================================================================================
+// Ticks a node outside of a tree, the node gets a scratch state block of its own.
+//==============================================================================================================================
+status_t tick( const node_i< timeData_t >& cNode, timeData_t timeData ) {
+    uint64_t                    state[ 4 ] {};
+    tickContext_t< timeData_t > context { timeData, reinterpret_cast< uint8_t* >( state ) };
+
+    return cNode.mTick( context );
+}
+
+//==============================================================================================================================
+// A large frame context that counts its copies, it must be passed through a tick without being copied.
+//==============================================================================================================================
+struct frame_t final {
+    static inline uint32_t numCopies { 0 };
+
+    float    timeDelta;
+    uint32_t payload[ 48 ] {};
+
+    frame_t( float cTimeDelta ) : timeDelta( cTimeDelta ) {}
+    frame_t( const frame_t& cFrame ) : timeDelta( cFrame.timeDelta ) { ++numCopies; }
+};
+
+//==============================================================================================================================
+// Allocates from the heap until told to run out of memory.
+//==============================================================================================================================
+template< typename type_t >
+struct failingAllocator_t {
+    using value_type = type_t;
+
+    bool* pIsOut;
+
+    type_t* allocate( size_t n ) {
+        if ( *pIsOut ) {
+            throw bad_alloc();
+        }
+
+        return allocator< type_t >().allocate( n );
+    }
+
+    void deallocate( type_t* p, size_t n ) noexcept { allocator< type_t >().deallocate( p, n ); }
+
+    template< typename other_t >
+    bool operator==( const failingAllocator_t< other_t >& cOther ) const noexcept { return pIsOut == cOther.pIsOut; }
+    template< typename other_t >
+    bool operator!=( const failingAllocator_t< other_t >& cOther ) const noexcept { return pIsOut != cOther.pIsOut; }
+
+    failingAllocator_t( bool* pOut ) : pIsOut( pOut ) {}
+    template< typename other_t >
+    failingAllocator_t( const failingAllocator_t< other_t >& cOther ) : pIsOut( cOther.pIsOut ) {}
+};
 
 //==============================================================================================================================
 void check_fbtActionNode( void ) {
@@ -77,12 +141,196 @@ void check_fbtActionNode( void ) {
         return status_t::RUNNING;
     } );
 
-    SMD_HASSERT( status_t::RUNNING == testObject.mTick( cTimeDelta ) );
+    SMD_HASSERT( status_t::RUNNING == tick( testObject, cTimeDelta ) );
     SMD_HASSERT( 1 == invokeCount );
 
     cout << setw( 100 ) << "check_fbtActionNode: " << " PASSED" << endl;
 }
 
+//==============================================================================================================================
+void check_fbtBatchCondition( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtBatchCondition: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    struct agent_t final {
+        float health;
+    };
+
+    using batchCondition_t = batchCondition_c< agent_t >;
+
+    auto lowHealth = []( const agent_t* pStates, size_t numStates, uint64_t* pMask ) {
+        for ( size_t iState { 0 }; iState < numStates; ++iState ) {
+            pMask[ iState >> 6 ] |= uint64_t( pStates[ iState ].health < 0.5f ) << ( iState & 63 );
+        }
+    };
+
+    testName = "Writes one bit per agent";
+    {
+        vector< agent_t > agents( 70, agent_t { 1.0f } );
+        agents[ 1 ].health  = 0.1f;
+        agents[ 69 ].health = 0.2f;
+
+        batchCondition_t testObject( "low-health", lowHealth );
+        testObject.mEvaluate( agents.data(), agents.size() );
+
+        SMD_HASSERT( 70 == testObject.mcGetNumStates() );
+        SMD_HASSERT( 2 == testObject.mcGetMask()[ 0 ] );
+        SMD_HASSERT( uint64_t( 1 ) << 5 == testObject.mcGetMask()[ 1 ] );
+        SMD_HASSERT( status_t::SUCCESS == testObject.mcGetStatus( 69 ) );
+        SMD_HASSERT( status_t::FAILURE == testObject.mcGetStatus( 68 ) );
+
+        const statusLanes_t cLanes { testObject.mcGetLanes( 1 ) };
+        SMD_HASSERT( uint64_t( 1 ) << 5 == cLanes.success );
+        SMD_HASSERT( 0x1f == cLanes.failure );
+    }
+    testPassed();
+
+    testName = "Leaf reads the result of its agent";
+    {
+        vector< agent_t > agents { { 1.0f }, { 0.1f } };
+
+        auto pCondition = make_shared< batchCondition_t >( "low-health", lowHealth );
+
+        shared_ptr< const tree_t > pTree = builder_t()
+            .mSequence( "agent" )
+                .mBatchCondition< agent_t >( "low-health", pCondition )
+            .mEnd()
+            .mBuild();
+
+        instance_t testObject0( pTree );
+        instance_t testObject1( pTree );
+        testObject0.mSetAgent( &agents[ 0 ] );
+        testObject1.mSetAgent( &agents[ 1 ] );
+
+        SMD_HASSERT( status_t::FAILURE == testObject1.mTick( 0.1f ) ); // Before the first evaluation.
+
+        pCondition->mEvaluate( agents.data(), agents.size() );
+
+        SMD_HASSERT( status_t::FAILURE == testObject0.mTick( 0.1f ) );
+        SMD_HASSERT( status_t::SUCCESS == testObject1.mTick( 0.1f ) );
+
+        pCondition->mEvaluate( agents.data(), 1 );
+
+        SMD_HASSERT( status_t::FAILURE == testObject1.mTick( 0.1f ) );
+        SMD_HASSERT( batchCondition_t::cNoAgent == pCondition->mcFind( &agents[ 1 ] ) );
+        SMD_HASSERT( batchCondition_t::cNoAgent == pCondition->mcFind( &testObject0 ) );
+    }
+    testPassed();
+
+    testName = "Agents and words out of the batch fail";
+    {
+        vector< agent_t > agents( 3, agent_t { 0.1f } );
+
+        batchCondition_t testObject( "low-health", lowHealth );
+
+        SMD_HASSERT( !testObject.mcTest( 0 ) );
+        SMD_HASSERT( 0 == testObject.mcGetLanes( 0 ).success && 0 == testObject.mcGetLanes( 0 ).failure );
+
+        testObject.mEvaluate( agents.data(), agents.size() );
+
+        SMD_HASSERT( testObject.mcTest( 2 ) && !testObject.mcTest( 3 ) && !testObject.mcTest( 64 ) );
+        SMD_HASSERT( 0 == testObject.mcGetLanes( 1 ).success && 0 == testObject.mcGetLanes( 1 ).failure );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtStatusLanes( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtStatusLanes: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    constexpr status_t cS { status_t::SUCCESS };
+    constexpr status_t cF { status_t::FAILURE };
+    constexpr status_t cR { status_t::RUNNING };
+
+    testName = "Inverts a single status";
+    {
+        static_assert( cF == invertStatus( cS ) );
+        static_assert( cS == invertStatus( cF ) );
+        static_assert( cR == invertStatus( cR ) );
+    }
+    testPassed();
+
+    testName = "Packs statuses by two bits";
+    {
+        vector< status_t > statuses;
+
+        for ( uint32_t iStatus { 0 }; iStatus < 70; ++iStatus ) {
+            statuses.push_back( static_cast< status_t >( iStatus % 3 ) );
+        }
+
+        uint64_t words[ 3 ];
+        packStatuses( statuses.data(), statuses.size(), words );
+
+        for ( uint32_t iStatus { 0 }; iStatus < 70; ++iStatus ) {
+            SMD_HASSERT( statuses[ iStatus ] == unpackStatus( words, iStatus ) );
+        }
+    }
+    testPassed();
+
+    testName = "Converts statuses to lanes and back";
+    {
+        const status_t cStatuses[] { cS, cF, cR, cF };
+        const statusLanes_t cLanes { toLanes( cStatuses, 4 ) };
+
+        SMD_HASSERT( 0b0001 == cLanes.success );
+        SMD_HASSERT( 0b1010 == cLanes.failure );
+        SMD_HASSERT( 0b0100 == runningLanes( cLanes, 0b1111 ) );
+
+        for ( uint32_t iLane { 0 }; iLane < 4; ++iLane ) {
+            SMD_HASSERT( cStatuses[ iLane ] == laneStatus( cLanes, iLane ) );
+            SMD_HASSERT( invertStatus( cStatuses[ iLane ] ) == laneStatus( invertLanes( cLanes ), iLane ) );
+        }
+    }
+    testPassed();
+
+    // Lanes: 0 = { S, S }, 1 = { S, F }, 2 = { F, S }, 3 = { R, S }, 4 = { S, R }.
+    const status_t cChild1[] { cS, cS, cF, cR, cS };
+    const status_t cChild2[] { cS, cF, cS, cS, cR };
+
+    testName = "Sequence lanes match sequence node";
+    {
+        sequenceLanes_c testObject( 0b11111 );
+
+        testObject.mAdd( toLanes( cChild1, 5 ) );
+        SMD_HASSERT( 0b10011 == testObject.mcGetPending() );
+
+        testObject.mAdd( toLanes( cChild2, 5 ) );
+        const statusLanes_t cResult { testObject.mcGetResult() };
+
+        SMD_HASSERT( cS == laneStatus( cResult, 0 ) );
+        SMD_HASSERT( cF == laneStatus( cResult, 1 ) );
+        SMD_HASSERT( cF == laneStatus( cResult, 2 ) );
+        SMD_HASSERT( cR == laneStatus( cResult, 3 ) );
+        SMD_HASSERT( cR == laneStatus( cResult, 4 ) );
+    }
+    testPassed();
+
+    testName = "Selector lanes match selector node";
+    {
+        selectorLanes_c testObject( 0b11111 );
+
+        testObject.mAdd( toLanes( cChild1, 5 ) );
+        SMD_HASSERT( 0b00100 == testObject.mcGetPending() );
+
+        testObject.mAdd( toLanes( cChild2, 5 ) );
+        const statusLanes_t cResult { testObject.mcGetResult() };
+
+        SMD_HASSERT( cS == laneStatus( cResult, 0 ) );
+        SMD_HASSERT( cS == laneStatus( cResult, 1 ) );
+        SMD_HASSERT( cS == laneStatus( cResult, 2 ) );
+        SMD_HASSERT( cR == laneStatus( cResult, 3 ) );
+        SMD_HASSERT( cS == laneStatus( cResult, 4 ) );
+    }
+    testPassed();
+}
+
 //==============================================================================================================================
 void check_fbtInverterNode( void ) {
     string testName;
@@ -91,11 +339,11 @@ void check_fbtInverterNode( void ) {
         cout << setw( 100 ) << ( "check_fbtInverterNode: " + testName + ": " ) << " PASSED" << endl;
     };
 
-    testName = "Ticking with no child node throws exception";
+    testName = "Inverter with no child node is incomplete";
     {
         inverterNode_t testObject( "some-action" );
 
-        SMD_CHK_EXCEPT_CT( testObject.mTick( 0.1f ) );
+        SMD_HASSERT( !testObject.mcIsComplete() );
     }
     testPassed();
 
@@ -112,9 +360,9 @@ void check_fbtInverterNode( void ) {
             return status_t::SUCCESS;
         } ) );
 
-        testObject.mAddChild( pMock1 );
+        testObject.mAddChild( pMock1.get() );
 
-        SMD_HASSERT( status_t::FAILURE == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::FAILURE == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
     }
@@ -133,9 +381,9 @@ void check_fbtInverterNode( void ) {
             return status_t::FAILURE;
         } ) );
 
-        testObject.mAddChild( pMock1 );
+        testObject.mAddChild( pMock1.get() );
 
-        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::SUCCESS == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
     }
@@ -154,9 +402,9 @@ void check_fbtInverterNode( void ) {
             return status_t::RUNNING;
         } ) );
 
-        testObject.mAddChild( pMock1 );
+        testObject.mAddChild( pMock1.get() );
 
-        SMD_HASSERT( status_t::RUNNING == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::RUNNING == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
     }
@@ -170,13 +418,13 @@ void check_fbtInverterNode( void ) {
             return status_t::RUNNING;
         } ) );
 
-        testObject.mAddChild( pMock1 );
+        testObject.mAddChild( pMock1.get() );
 
         nodePtr_t pMock2( new actionNode_t( "mock2", [ & ]( timeData_t ) ->status_t {
             return status_t::RUNNING;
         } ) );
 
-        SMD_CHK_EXCEPT_CT( testObject.mAddChild( pMock2 ) );
+        SMD_CHK_EXCEPT_CT( testObject.mAddChild( pMock2.get() ) );
     }
     testPassed();
 }
@@ -211,10 +459,10 @@ void check_fbtParallelNode( void ) {
             return status_t::RUNNING;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::RUNNING == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::RUNNING == tick( testObject, cTimeDelta ) );
         SMD_HASSERT( 2 == callOrder );
 
         SMD_HASSERT( 1 == mock1Times );
@@ -247,11 +495,11 @@ void check_fbtParallelNode( void ) {
             return status_t::RUNNING;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
-        testObject.mAddChild( pMock3 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
+        testObject.mAddChild( pMock3.get() );
 
-        SMD_HASSERT( status_t::FAILURE == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::FAILURE == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 1 == mock2Times );
@@ -284,11 +532,11 @@ void check_fbtParallelNode( void ) {
             return status_t::RUNNING;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
-        testObject.mAddChild( pMock3 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
+        testObject.mAddChild( pMock3.get() );
 
-        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::SUCCESS == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 1 == mock2Times );
@@ -315,10 +563,10 @@ void check_fbtParallelNode( void ) {
             return status_t::FAILURE;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::RUNNING == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::RUNNING == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 1 == mock2Times );
@@ -353,10 +601,10 @@ void check_fbtSelectorNode( void ) {
             return status_t::SUCCESS;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::SUCCESS == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 0 == mock2Times );
@@ -382,10 +630,10 @@ void check_fbtSelectorNode( void ) {
             return status_t::RUNNING;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::RUNNING == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::RUNNING == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 0 == mock2Times );
@@ -411,10 +659,10 @@ void check_fbtSelectorNode( void ) {
             return status_t::SUCCESS;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::SUCCESS == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 1 == mock2Times );
@@ -440,10 +688,10 @@ void check_fbtSelectorNode( void ) {
             return status_t::FAILURE;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::FAILURE == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::FAILURE == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 1 == mock2Times );
@@ -481,10 +729,10 @@ void check_fbtSequenceNode( void ) {
             return status_t::SUCCESS;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::SUCCESS == tick( testObject, cTimeDelta ) );
         SMD_HASSERT( 2 == callOrder );
 
         SMD_HASSERT( 1 == mock1Times );
@@ -511,10 +759,10 @@ void check_fbtSequenceNode( void ) {
             return status_t::RUNNING;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::RUNNING == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::RUNNING == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 0 == mock2Times );
@@ -540,10 +788,10 @@ void check_fbtSequenceNode( void ) {
             return status_t::FAILURE;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::FAILURE == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::FAILURE == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 0 == mock2Times );
@@ -569,10 +817,10 @@ void check_fbtSequenceNode( void ) {
             return status_t::FAILURE;
         } ) );
 
-        testObject.mAddChild( pMock1 );
-        testObject.mAddChild( pMock2 );
+        testObject.mAddChild( pMock1.get() );
+        testObject.mAddChild( pMock2.get() );
 
-        SMD_HASSERT( status_t::FAILURE == testObject.mTick( cTimeDelta ) );
+        SMD_HASSERT( status_t::FAILURE == tick( testObject, cTimeDelta ) );
 
         SMD_HASSERT( 1 == mock1Times );
         SMD_HASSERT( 1 == mock2Times );
@@ -618,7 +866,7 @@ void check_fbtBuilder( void ) {
             .mEnd()
             .mBuild();
 
-        SMD_HASSERT( typeid( inverterNode_t ) == typeid( *pNode ) );
+        SMD_HASSERT( typeid( inverterNode_t ) == typeid( *pNode->mcGetRoot() ) );
         SMD_HASSERT( status_t::FAILURE == pNode->mTick( 0.1f ) );
     }
     testPassed();
@@ -636,6 +884,105 @@ void check_fbtBuilder( void ) {
     }
     testPassed();
 
+    testName = "Cant end an inverter with no child";
+    {
+        builder_t testObject;
+
+        SMD_CHK_EXCEPT_CT(
+            testObject
+                .mSequence( "some-sequence" )
+                    .mInverter( "some-inverter" )
+                    .mEnd()
+                .mEnd()
+                .mBuild();
+        );
+    }
+    testPassed();
+
+    testName = "Cant end more nodes than were created";
+    {
+        builder_t testObject;
+
+        SMD_CHK_EXCEPT_CT(
+            testObject
+                .mSequence( "some-sequence" )
+                .mEnd()
+                .mEnd()
+        );
+    }
+    testPassed();
+
+    testName = "Moves an rvalue function into the node without copies";
+    {
+        struct counted_t final {
+            uint32_t* pNumCopies;
+
+            status_t operator()( timeData_t ) const { return status_t::SUCCESS; }
+
+            counted_t( uint32_t* pCopies ) : pNumCopies( pCopies ) {}
+            counted_t( const counted_t& cOther ) : pNumCopies( cOther.pNumCopies ) { ++*pNumCopies; }
+            counted_t( counted_t&& other ) noexcept : pNumCopies( other.pNumCopies ) {}
+        };
+
+        uint32_t numCopies { 0 };
+
+        builder_t testObject;
+
+        auto pNode = testObject
+            .mSequence( "some-sequence" )
+                .mDo( "some-action", counted_t( &numCopies ) )
+            .mEnd()
+            .mBuild();
+
+        SMD_HASSERT( 0 == numCopies );
+        SMD_HASSERT( status_t::SUCCESS == pNode->mTick( 0.1f ) );
+    }
+    testPassed();
+
+    testName = "Nodes are movable";
+    {
+        uint32_t invokeCount { 0 };
+
+        actionNode_t action( "some-action", [ & ]( timeData_t ) { ++invokeCount; return status_t::SUCCESS; } );
+        actionNode_t movedAction( move( action ) );
+
+        sequenceNode_t sequence( "some-sequence" );
+        actionNode_t lastAction( move( movedAction ) );
+        sequence.mAddChild( &lastAction );
+
+        sequenceNode_t movedSequence( move( sequence ) );
+
+        SMD_HASSERT( "some-sequence" == movedSequence.mcName );
+        SMD_HASSERT( status_t::SUCCESS == tick( movedSequence, 0.1f ) );
+        SMD_HASSERT( 1 == invokeCount );
+    }
+    testPassed();
+
+    testName = "Cant create an empty composite";
+    {
+        builder_t testObject;
+
+        SMD_CHK_EXCEPT_CT(
+            testObject
+                .mSequence( "some-sequence" )
+                    .mSelector( "some-selector" )
+                    .mEnd()
+        );
+    }
+    testPassed();
+
+    testName = "Cant create an action with an empty function";
+    {
+        builder_t testObject;
+
+        SMD_CHK_EXCEPT_CT(
+            testObject
+                .mSequence( "some-sequence" )
+                    .mDo( "some-node", nullptr )
+        );
+    }
+    testPassed();
+
     testName = "Condition is syntactic sugar for do";
     {
         builder_t testObject;
@@ -646,8 +993,9 @@ void check_fbtBuilder( void ) {
             .mEnd()
             .mBuild();
 
-        SMD_HASSERT( typeid( inverterNode_t ) == typeid( *pNode ) );
+        SMD_HASSERT( typeid( inverterNode_t ) == typeid( *pNode->mcGetRoot() ) );
         SMD_HASSERT( status_t::FAILURE == pNode->mTick( 0.1f ) );
+        SMD_HASSERT( nodeKind_t::CONDITION == static_cast< const parentNode_i< timeData_t >& >( *pNode->mcGetRoot() ).mcGetChildren()[ 0 ]->mcKind );
     }
     testPassed();
 
@@ -663,7 +1011,7 @@ void check_fbtBuilder( void ) {
             .mEnd()
             .mBuild();
 
-        SMD_HASSERT( typeid( inverterNode_t ) == typeid( *pNode ) );
+        SMD_HASSERT( typeid( inverterNode_t ) == typeid( *pNode->mcGetRoot() ) );
         SMD_HASSERT( status_t::SUCCESS == pNode->mTick( 0.1f ) );
     }
     testPassed();
@@ -702,7 +1050,7 @@ void check_fbtBuilder( void ) {
             .mEnd()
             .mBuild();
 
-        SMD_HASSERT( typeid( sequenceNode_t ) == typeid( *pNode ) );
+        SMD_HASSERT( typeid( sequenceNode_t ) == typeid( *pNode->mcGetRoot() ) );
         SMD_HASSERT( status_t::SUCCESS == pNode->mTick( 0.1f ) );
         SMD_HASSERT( 2 == invokeCount );
     }
@@ -727,7 +1075,7 @@ void check_fbtBuilder( void ) {
             .mEnd()
             .mBuild();
 
-        SMD_HASSERT( typeid( parallelNode_t ) == typeid( *pNode ) );
+        SMD_HASSERT( typeid( parallelNode_t ) == typeid( *pNode->mcGetRoot() ) );
         SMD_HASSERT( status_t::SUCCESS == pNode->mTick( 0.1f ) );
         SMD_HASSERT( 2 == invokeCount );
     }
@@ -752,7 +1100,7 @@ void check_fbtBuilder( void ) {
             .mEnd()
             .mBuild();
 
-        SMD_HASSERT( typeid( selectorNode_t ) == typeid( *pNode ) );
+        SMD_HASSERT( typeid( selectorNode_t ) == typeid( *pNode->mcGetRoot() ) );
         SMD_HASSERT( status_t::SUCCESS == pNode->mTick( 0.1f ) );
         SMD_HASSERT( 2 == invokeCount );
     }
@@ -775,13 +1123,44 @@ void check_fbtBuilder( void ) {
 
         auto pTree = testObject
             .mSequence( "parent-tree" )
-                .mSplice( pSpliced )
+                .mSplice( move( pSpliced ) )
             .mEnd()
             .mBuild();
 
         pTree->mTick( 0.1f );
 
         SMD_HASSERT( 1 == invokeCount );
+        SMD_HASSERT( 2 == pTree->mcGetNumNodes() );
+        SMD_HASSERT( nodeKind_t::SUBTREE ==
+                     static_cast< const parentNode_i< timeData_t >& >( *pTree->mcGetRoot() ).mcGetChildren()[ 0 ]->mcKind );
+    }
+    testPassed();
+
+    testName = "Spliced sub tree is shared by all trees that splice it";
+    {
+        builder_t testObject;
+
+        uint32_t invokeCount { 0 };
+
+        shared_ptr< const tree_c< timeData_t > > pSpliced = testObject
+            .mSequence( "spliced" )
+                .mDo( "test", [ & ]( timeData_t ) {
+                    ++invokeCount;
+                    return status_t::SUCCESS;
+                } )
+            .mEnd()
+            .mBuild();
+
+        auto pTree1 = testObject.mSequence( "parent-tree-1" ).mSplice( pSpliced ).mEnd().mBuild();
+        auto pTree2 = testObject.mSequence( "parent-tree-2" ).mSplice( pSpliced ).mEnd().mBuild();
+
+        SMD_HASSERT( 3 == pSpliced.use_count() );
+        pSpliced.reset();
+
+        pTree1->mTick( 0.1f );
+        pTree2->mTick( 0.1f );
+
+        SMD_HASSERT( 2 == invokeCount );
     }
     testPassed();
 
@@ -802,22 +1181,2659 @@ void check_fbtBuilder( void ) {
 
         SMD_CHK_EXCEPT_CT(
             testObject
-                .mSplice( pSpliced )
+                .mSplice( move( pSpliced ) )
         );
     }
     testPassed();
 }
 
+//==============================================================================================================================
+void check_fbtOptimizer( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtOptimizer: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    auto getChildren = []( const unique_ptr< tree_c< timeData_t > >& cpTree ) ->const vector< node_i< timeData_t >* >& {
+        return static_cast< const parentNode_i< timeData_t >& >( *cpTree->mcGetRoot() ).mcGetChildren();
+    };
+
+    testName = "Collapses double inverters";
+    {
+        builder_t builder;
+
+        auto pTree = builder
+            .mSelector( "some-selector" )
+                .mInverter( "some-inverter" )
+                    .mInverter( "some-other-inverter" )
+                        .mDo( "some-action", []( timeData_t ) { return status_t::RUNNING; } )
+                    .mEnd()
+                .mEnd()
+                .mDo( "some-other-action", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mEnd()
+            .mBuild();
+
+        optimizer_t testObject;
+        testObject.mRun( *pTree );
+
+        SMD_HASSERT( 2 == testObject.mcGetNumRemoved() );
+        SMD_HASSERT( "some-action" == getChildren( pTree )[ 0 ]->mcName );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+    }
+    testPassed();
+
+    testName = "Flattens nested composites of the same kind and removes single child composites";
+    {
+        builder_t builder;
+
+        uint32_t invokeCount { 0 };
+
+        auto pTree = builder
+            .mSequence( "root" )
+                .mSequence( "nested" )
+                    .mDo( "some-action-1", [ & ]( timeData_t ) { ++invokeCount; return status_t::SUCCESS; } )
+                    .mDo( "some-action-2", [ & ]( timeData_t ) { ++invokeCount; return status_t::SUCCESS; } )
+                .mEnd()
+                .mSelector( "single" )
+                    .mDo( "some-action-3", [ & ]( timeData_t ) { ++invokeCount; return status_t::SUCCESS; } )
+                .mEnd()
+            .mEnd()
+            .mBuild();
+
+        optimizer_t testObject;
+        testObject.mRun( *pTree );
+
+        SMD_HASSERT( 2 == testObject.mcGetNumRemoved() );
+        SMD_HASSERT( 3 == getChildren( pTree ).size() );
+        SMD_HASSERT( "some-action-3" == getChildren( pTree )[ 2 ]->mcName );
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( 3 == invokeCount );
+    }
+    testPassed();
+
+    testName = "Removes children after a child that never fails in a selector";
+    {
+        builder_t builder;
+
+        auto pTree = builder
+            .mSelector( "root" )
+                .mCondition( "some-condition", []( timeData_t ) { return false; } )
+                .mParallel( "always-running", 0, 0 )
+                    .mDo( "some-action", []( timeData_t ) { return status_t::FAILURE; } )
+                .mEnd()
+                .mDo( "unreachable", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mEnd()
+            .mBuild();
+
+        optimizer_t testObject;
+        testObject.mRun( *pTree );
+
+        SMD_HASSERT( 1 == testObject.mcGetUnreachable().size() );
+        SMD_HASSERT( "unreachable" == testObject.mcGetUnreachable()[ 0 ] );
+        SMD_HASSERT( 2 == getChildren( pTree ).size() );
+        SMD_HASSERT( ( optimizer_t::cCanSucceed | optimizer_t::cCanRun ) == testObject.mcGetOutcomes( *pTree->mcGetRoot() ) );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+    }
+    testPassed();
+
+    testName = "Destroys the nodes dropped from the tree";
+    {
+        builder_t builder;
+
+        auto pTree = builder
+            .mSequence( "root" )
+                .mSequence( "nested" )
+                    .mDo( "some-action-1", []( timeData_t ) { return status_t::SUCCESS; } )
+                    .mDo( "some-action-2", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+                .mSelector( "single" )
+                    .mInverter( "never-succeeds" )
+                        .mWait( "some-wait", 7 )
+                    .mEnd()
+                .mEnd()
+                .mSelector( "unreachable-parent" )
+                    .mDo( "some-action-3", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+            .mEnd()
+            .mBuild();
+
+        const uint32_t cNestedId { pTree->mcFind( "root/nested" )->mcGetId() };
+        const uint32_t cActionId { pTree->mcFind( "root/nested/some-action-1" )->mcGetId() };
+        const uint32_t cSingleId { pTree->mcFind( "root/single" )->mcGetId() };
+        const uint32_t cLastId   { pTree->mcFind( "root/unreachable-parent/some-action-3" )->mcGetId() };
+
+        SMD_HASSERT( 9 == pTree->mcGetNumNodes() );
+
+        optimizer_t testObject;
+        testObject.mRun( *pTree );
+
+        SMD_HASSERT( 5 == pTree->mcGetNumNodes() );
+        SMD_HASSERT( !pTree->mGetNode( cNestedId ) && !pTree->mGetNode( cSingleId ) && !pTree->mGetNode( cLastId ) );
+        SMD_HASSERT( pTree->mGetNode( cActionId ) == pTree->mcFind( "root/some-action-1" ) );
+        SMD_HASSERT( 0 == pTree->mDestroyDetached() );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtCodegen( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtCodegen: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    testName = "Emits straight-line code calling leaves by index";
+    {
+        builder_t builder;
+
+        auto pTree = builder
+            .mSelector( "some-selector" )
+                .mCondition( "some-condition", []( timeData_t ) { return true; } )
+                .mInverter( "some-inverter" )
+                    .mDo( "some-action", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+            .mEnd()
+            .mBuild();
+
+        codegen_c< timeData_t > testObject;
+
+        const string cCode { testObject.mEmit( *pTree->mcGetRoot(), "tickTree", "fbt.hpp" ) };
+
+        const string cExpected {
+            "// Generated by 'smd::fbt::codegen_c' from the tree \"some-selector\", don't edit.\n"
+            "\n"
+            "#pragma once\n"
+            "\n"
+            "#include \"fbt.hpp\"\n"
+            "\n"
+            "#include <cstdint>\n"
+            "#include <type_traits>\n"
+            "\n"
+            "template< typename timeData_t, typename leaves_t >\n"
+            "inline smd::fbt::status_t tickTree( leaves_t& leaves, smd::fbt::param_t< timeData_t > timeData ) noexcept {\n"
+            "    using smd::fbt::status_t;\n"
+            "\n"
+            "    status_t status;\n"
+            "\n"
+            "    do { // \"some-selector\"\n"
+            "        status = leaves( std::integral_constant< size_t, 0 >(), timeData ) ? "
+                    "status_t::SUCCESS : status_t::FAILURE; // \"some-condition\"\n"
+            "        if ( status != status_t::FAILURE ) break;\n"
+            "        status = leaves( std::integral_constant< size_t, 1 >(), timeData ); // \"some-action\"\n"
+            "        status = smd::fbt::invertStatus( status ); // \"some-inverter\"\n"
+            "    } while ( false );\n"
+            "\n"
+            "    return status;\n"
+            "}\n"
+            "\n"
+            "constexpr const char* tickTreeLeaves[] {\n"
+            "    \"some-condition\",\n"
+            "    \"some-action\",\n"
+            "};\n"
+        };
+
+        SMD_HASSERT( cExpected == cCode );
+        SMD_HASSERT( 2 == testObject.mcGetLeaves().size() );
+        SMD_HASSERT( "some-action" == testObject.mcGetLeaves()[ 1 ]->mcName );
+    }
+    testPassed();
+
+    testName = "Escapes the names of the nodes and cant emit a function that isnt an identifier";
+    {
+        auto pTree = builder_t()
+            .mSequence( "root" )
+                .mDo( "a\"b\\c\nd\te\x01" "7\x7F", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mEnd()
+            .mBuild();
+
+        codegen_c< timeData_t > testObject;
+
+        const string cCode { testObject.mEmit( *pTree->mcGetRoot(), "_tick2" ) };
+
+        SMD_HASSERT( string::npos != cCode.find( "    \"a\\\"b\\\\c\\nd\\011e\\0017\\177\",\n" ) );
+
+        for ( const char* cpFunction : { "", "2tick", "tick-tree", "tick tree", "tick\n", "tick::tree", "delete", "and" } ) {
+            SMD_CHK_EXCEPT_CT( testObject.mEmit( *pTree->mcGetRoot(), cpFunction ) );
+        }
+    }
+    testPassed();
+
+    testName = "Generated code ticks like the tree it was generated from";
+    {
+        uint32_t iTick { 0 };
+
+        auto isEnemyVisible = [ &iTick ]( timeData_t ) { return iTick % 3 == 0; };
+        auto shoot          = [ &iTick ]( timeData_t ) { return iTick % 2 ? status_t::RUNNING : status_t::SUCCESS; };
+        auto patrol         = [ &iTick ]( timeData_t ) { return static_cast< status_t >( iTick % 3 ); };
+        auto isTired        = [ &iTick ]( timeData_t ) { return iTick % 4 < 2; };
+
+        // "generated-tree.hpp" is emitted from this tree with "../include/fluent-behaviour-tree.hpp" as the include.
+        auto pTree = builder_t()
+            .mSelector( "agent" )
+                .mSequence( "attack" )
+                    .mCondition( "is-enemy-visible", isEnemyVisible )
+                    .mDo( "shoot", shoot )
+                .mEnd()
+                .mParallel( "idle", 2, 1 )
+                    .mDo( "patrol", patrol )
+                    .mInverter( "is-rested" )
+                        .mCondition( "is-tired", isTired )
+                    .mEnd()
+                .mEnd()
+            .mEnd()
+            .mBuild();
+
+        codegen_c< timeData_t > testObject;
+        testObject.mEmit( *pTree->mcGetRoot(), "tickGeneratedTree", "../include/fluent-behaviour-tree.hpp" );
+
+        SMD_HASSERT( size( tickGeneratedTreeLeaves ) == testObject.mcGetLeaves().size() );
+        for ( size_t iLeaf = 0; iLeaf < size( tickGeneratedTreeLeaves ); ++iLeaf ) {
+            SMD_HASSERT( tickGeneratedTreeLeaves[ iLeaf ] == testObject.mcGetLeaves()[ iLeaf ]->mcName );
+        }
+
+        auto leaves = [ & ]( auto cIndex, timeData_t timeData ) {
+            if constexpr ( 0 == cIndex ) {
+                return isEnemyVisible( timeData );
+            } else if constexpr ( 1 == cIndex ) {
+                return shoot( timeData );
+            } else if constexpr ( 2 == cIndex ) {
+                return patrol( timeData );
+            } else {
+                return isTired( timeData );
+            }
+        };
+
+        set< status_t > statuses;
+
+        for ( iTick = 0; iTick < 12; ++iTick ) {
+            const status_t cStatus { pTree->mTick( 0.1f ) };
+
+            SMD_HASSERT( cStatus == tickGeneratedTree< timeData_t >( leaves, 0.1f ) );
+            statuses.insert( cStatus );
+        }
+
+        SMD_HASSERT( 3 == statuses.size() );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtLibrary( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtLibrary: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    testName = "Trees splice a behaviour from the library without copying it";
+    {
+        library_t testObject;
+        uint32_t  invokeCount { 0 };
+
+        testObject.mDefine( "flee", builder_t()
+            .mSequence( "flee" )
+                .mDo( "run-away", [ & ]( timeData_t ) { ++invokeCount; return status_t::RUNNING; } )
+            .mEnd()
+            .mBuild() );
+
+        auto pTree1 = builder_t().mSelector( "agent1" ).mSplice( testObject, "flee" ).mEnd().mBuild();
+        auto pTree2 = builder_t().mSelector( "agent2" ).mSplice( testObject, "flee" ).mEnd().mBuild();
+
+        SMD_HASSERT( 1 == testObject.mcGetNumTrees() );
+        SMD_HASSERT( 3 == testObject.mcGet( "flee" ).use_count() );
+        SMD_HASSERT( 2 == pTree1->mcGetNumNodes() && 2 == pTree2->mcGetNumNodes() );
+        SMD_HASSERT( status_t::RUNNING == pTree1->mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == pTree2->mTick( 0.1f ) );
+        SMD_HASSERT( 2 == invokeCount );
+    }
+    testPassed();
+
+    testName = "Instances of a shared tree keep their own state";
+    {
+        bool isAlerted { true };
+
+        shared_ptr< const tree_t > pTree = builder_t()
+            .mSequence( "patrol" )
+                .mCondition( "is-alerted", [ & ]( timeData_t ) { return isAlerted; } )
+                .mDo( "walk", []( timeData_t ) { return status_t::RUNNING; } )
+            .mEnd()
+            .mBuild();
+
+        const auto& cSequence = static_cast< const sequenceNode_t& >( *pTree->mcGetRoot() );
+
+        instance_t testObject1( pTree );
+        instance_t testObject2( pTree );
+
+        SMD_HASSERT( sizeof( uint32_t ) == testObject1.mcGetStateSize() );
+        SMD_HASSERT( status_t::RUNNING == testObject1.mTick( 0.1f ) );
+        isAlerted = false;
+        SMD_HASSERT( status_t::FAILURE == testObject2.mTick( 0.1f ) );
+
+        tickContext_t< timeData_t > context1 { 0.0f, testObject1.mGetState() };
+        tickContext_t< timeData_t > context2 { 0.0f, testObject2.mGetState() };
+
+        SMD_HASSERT( 1 == cSequence.mcGetRunningChild( context1 ) );
+        SMD_HASSERT( sequenceNode_t::cNoChild == cSequence.mcGetRunningChild( context2 ) );
+
+        testObject1.mReset();
+        SMD_HASSERT( sequenceNode_t::cNoChild == cSequence.mcGetRunningChild( context1 ) );
+    }
+    testPassed();
+
+    testName = "Spliced behaviour state is laid out inside the splicing tree";
+    {
+        library_t library;
+
+        const auto& cpFlee = library.mDefine( "flee", builder_t()
+            .mSequence( "flee" )
+                .mDo( "run-away", []( timeData_t ) { return status_t::RUNNING; } )
+            .mEnd()
+            .mBuild() );
+
+        shared_ptr< const tree_t > pTree = builder_t()
+            .mSelector( "agent" )
+                .mSplice( library, "flee" )
+            .mEnd()
+            .mBuild();
+
+        const auto& cSubtree = *static_cast< const parentNode_i< timeData_t >& >( *pTree->mcGetRoot() ).mcGetChildren().front();
+
+        SMD_HASSERT( sizeof( uint32_t ) == cpFlee->mcGetStateSize() );
+        SMD_HASSERT( 8 == cSubtree.mcGetStateOffset() );
+        SMD_HASSERT( 12 == pTree->mcGetStateSize() );
+
+        instance_t testObject( pTree );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+
+        tickContext_t< timeData_t > context { 0.0f, testObject.mGetState() + cSubtree.mcGetStateOffset() };
+
+        SMD_HASSERT( 0 == static_cast< const sequenceNode_t& >( *cpFlee->mcGetRoot() ).mcGetRunningChild( context ) );
+    }
+    testPassed();
+
+    testName = "Cant define a behaviour twice or use an unknown one";
+    {
+        library_t testObject;
+
+        testObject.mDefine( "flee", builder_t().mSequence( "flee" ).mDo( "run-away", []( timeData_t ) { return status_t::RUNNING; } ).mEnd().mBuild() );
+
+        SMD_CHK_EXCEPT_CT( testObject.mDefine( "flee", builder_t().mSelector( "flee" ).mDo( "hide", []( timeData_t ) { return status_t::RUNNING; } ).mEnd().mBuild() ) );
+        SMD_CHK_EXCEPT_CT( testObject.mDefine( "patrol", nullptr ) );
+        SMD_CHK_EXCEPT_CT( testObject.mcGet( "patrol" ) );
+        SMD_CHK_EXCEPT_CT( builder_t().mSequence( "agent" ).mSplice( testObject, "patrol" ) );
+        SMD_CHK_EXCEPT_CT( instance_t( nullptr ) );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtSnapshot( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtSnapshot: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    bool isAlerted { true };
+
+    shared_ptr< const tree_t > pTree = builder_t()
+        .mSelector( "agent" )
+            .mSequence( "patrol" )
+                .mCondition( "is-alerted", [ & ]( timeData_t ) { return isAlerted; } )
+                .mDo( "walk", []( timeData_t ) { return status_t::RUNNING; } )
+            .mEnd()
+        .mEnd()
+        .mBuild();
+
+    testName = "Restoring a snapshot brings back the running state";
+    {
+        instance_t testObject( pTree );
+
+        isAlerted = true;
+        testObject.mTick( 0.1f );
+
+        vector< stateWord_t > snapshot( testObject.mcGetNumWords() );
+        testObject.mcSnapshot( snapshot.data() );
+
+        const vector< uint8_t > cRunning( testObject.mcGetState(), testObject.mcGetState() + testObject.mcGetStateSize() );
+
+        isAlerted = false;
+        testObject.mTick( 0.1f );
+        SMD_HASSERT( !equal( cRunning.cbegin(), cRunning.cend(), testObject.mcGetState() ) );
+
+        testObject.mRestore( snapshot.data() );
+        SMD_HASSERT( equal( cRunning.cbegin(), cRunning.cend(), testObject.mcGetState() ) );
+    }
+    testPassed();
+
+    testName = "Diff tells which words of two snapshots differ";
+    {
+        instance_t testObject( pTree );
+
+        vector< stateWord_t > snapshot1( testObject.mcGetNumWords() );
+        vector< stateWord_t > snapshot2( testObject.mcGetNumWords() );
+        vector< uint32_t >    changed;
+
+        isAlerted = true;
+        testObject.mTick( 0.1f );
+        testObject.mcSnapshot( snapshot1.data() );
+        testObject.mTick( 0.1f );
+        testObject.mcSnapshot( snapshot2.data() );
+
+        SMD_HASSERT( 2 == testObject.mcGetNumWords() );
+        SMD_HASSERT( isSameState( snapshot1.data(), snapshot2.data(), snapshot1.size() ) );
+        SMD_HASSERT( 0 == diffStates( snapshot1.data(), snapshot2.data(), snapshot1.size() ) );
+
+        isAlerted = false;
+        testObject.mTick( 0.1f );
+        testObject.mcSnapshot( snapshot2.data() );
+
+        SMD_HASSERT( !isSameState( snapshot1.data(), snapshot2.data(), snapshot1.size() ) );
+        SMD_HASSERT( 2 == diffStates( snapshot1.data(), snapshot2.data(), snapshot1.size(), &changed ) );
+        SMD_HASSERT( ( vector< uint32_t > { 0, 1 } ) == changed );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtParallelTicker( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtParallelTicker: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    using ticker_t = parallelTicker_c< timeData_t, size_t >;
+
+    shared_ptr< const tree_t > pTree = builder_t()
+        .mSequence( "agent" )
+            .mDo( "report", []( timeData_t ) {
+                ticker_t::mEmit( ticker_t::mGetAgent() );
+                return status_t::SUCCESS;
+            } )
+            .mDo( "report-twice", []( timeData_t ) {
+                ticker_t::mEmit( ticker_t::mGetAgent() * 2 );
+                return status_t::RUNNING;
+            } )
+        .mEnd()
+        .mBuild();
+
+    testName = "Commands come in agent order regardless of the number of threads";
+    {
+        vector< instance_t > instances( 1001, instance_t( pTree ) );
+
+        vector< size_t > expected;
+        for ( size_t iAgent = 0; iAgent < instances.size(); ++iAgent ) {
+            expected.emplace_back( iAgent );
+            expected.emplace_back( iAgent * 2 );
+        }
+
+        for ( uint32_t numThreads : { 1, 2, 3, 8 } ) {
+            ticker_t testObject( numThreads );
+
+            SMD_HASSERT( expected == testObject.mTick( instances.data(), instances.size(), 0.1f ) );
+            SMD_HASSERT( expected == testObject.mTick( instances.data(), instances.size(), 0.1f ) );
+        }
+    }
+    testPassed();
+
+    testName = "Ticks fewer agents than threads";
+    {
+        vector< instance_t > instances( 2, instance_t( pTree ) );
+        ticker_t             testObject( 4 );
+
+        SMD_HASSERT( ( vector< size_t > { 0, 0, 1, 2 } ) == testObject.mTick( instances.data(), instances.size(), 0.1f ) );
+        SMD_HASSERT( testObject.mTick( nullptr, 0, 0.1f ).empty() );
+    }
+    testPassed();
+
+    testName = "Keeps its workers when moved";
+    {
+        vector< instance_t > instances( 5, instance_t( pTree ) );
+        ticker_t             testObject( 3 );
+        ticker_t             moved( 2 );
+
+        testObject.mTick( instances.data(), instances.size(), 0.1f );
+        moved = move( testObject );
+
+        SMD_HASSERT( 3 == moved.mcGetNumThreads() );
+        SMD_HASSERT( 10 == moved.mTick( instances.data(), instances.size(), 0.1f ).size() );
+    }
+    testPassed();
+
+    testName = "Cant emit outside of a parallel tick";
+    {
+        SMD_CHK_EXCEPT_CT( ticker_t::mEmit( 0 ) );
+        SMD_HASSERT( SIZE_MAX == ticker_t::mGetAgent() );
+        SMD_CHK_EXCEPT_CT( ticker_t( 0 ) );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtProfiler( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtProfiler: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    auto pTree = builder_t()
+        .mSequence( "agent" )
+            .mSelector( "pick \"target\"" )
+                .mDo( "some-action", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mEnd()
+        .mEnd()
+        .mBuild();
+
+    testName = "Records spans of the tree and its composite nodes";
+    {
+        profiler_c testObject( 16 );
+
+        pTree->mTick( 0.1f, &testObject );
+
+        SMD_HASSERT( 3 == testObject.mcGetNumSpans() );
+        SMD_HASSERT( "pick \"target\"" == *testObject.mcGetSpan( 0 ).pName );
+        SMD_HASSERT( "agent" == *testObject.mcGetSpan( 1 ).pName && string( "node" ) == testObject.mcGetSpan( 1 ).pCategory );
+        SMD_HASSERT( "agent" == *testObject.mcGetSpan( 2 ).pName && string( "tree" ) == testObject.mcGetSpan( 2 ).pCategory );
+        SMD_HASSERT( testObject.mcGetSpan( 2 ).begin <= testObject.mcGetSpan( 1 ).begin );
+        SMD_HASSERT( testObject.mcGetSpan( 1 ).end <= testObject.mcGetSpan( 2 ).end );
+    }
+    testPassed();
+
+    testName = "Keeps the latest spans within its capacity";
+    {
+        profiler_c testObject( 4 );
+
+        pTree->mTick( 0.1f, &testObject );
+        pTree->mTick( 0.1f, &testObject );
+
+        SMD_HASSERT( 4 == testObject.mcGetNumSpans() );
+        SMD_HASSERT( "agent" == *testObject.mcGetSpan( 0 ).pName );
+        SMD_HASSERT( "pick \"target\"" == *testObject.mcGetSpan( 1 ).pName );
+        SMD_HASSERT( string( "tree" ) == testObject.mcGetSpan( 3 ).pCategory );
+    }
+    testPassed();
+
+    testName = "Records nothing while disabled";
+    {
+        profiler_c testObject( 4 );
+
+        testObject.mSetEnabled( false );
+        pTree->mTick( 0.1f, &testObject );
+        SMD_HASSERT( 0 == testObject.mcGetNumSpans() );
+
+        testObject.mSetEnabled( true );
+        pTree->mTick( 0.1f, &testObject );
+        SMD_HASSERT( 3 == testObject.mcGetNumSpans() );
+
+        testObject.mClear();
+        SMD_HASSERT( 0 == testObject.mcGetNumSpans() );
+    }
+    testPassed();
+
+    testName = "Writes trace-event JSON";
+    {
+        profiler_c testObject( 4 );
+        testObject.mRecord( pTree->mcGetRoot()->mcName, "tree", 1500, 4000 );
+
+        ostringstream stream;
+        testObject.mcWriteChromeTrace( stream );
+
+        SMD_HASSERT( "{\"traceEvents\":[\n"
+                     "{\"name\":\"agent\",\"cat\":\"tree\",\"ph\":\"X\",\"ts\":1.500,\"dur\":2.500,\"pid\":0,\"tid\":" +
+                     to_string( profiler_c::mGetThreadId() ) + "}\n"
+                     "]}\n" == stream.str() );
+        SMD_CHK_EXCEPT_CT( profiler_c( 0 ) );
+    }
+    testPassed();
+
+    testName = "Spans keep their names after the tree is gone";
+    {
+        profiler_c testObject( 8 );
+
+        {
+            auto pGone = builder_t()
+                .mSequence( "gone" )
+                    .mSelector( "also-gone" )
+                        .mDo( "some-action", []( timeData_t ) { return status_t::SUCCESS; } )
+                    .mEnd()
+                .mEnd()
+                .mBuild();
+
+            pGone->mTick( 0.1f, &testObject );
+            pGone->mTick( 0.1f, &testObject );
+        }
+
+        SMD_HASSERT( 6 == testObject.mcGetNumSpans() );
+        SMD_HASSERT( "also-gone" == *testObject.mcGetSpan( 0 ).pName && "gone" == *testObject.mcGetSpan( 5 ).pName );
+        SMD_HASSERT( testObject.mcGetSpan( 0 ).pName == testObject.mcGetSpan( 3 ).pName );
+
+        ostringstream stream;
+        testObject.mcWriteChromeTrace( stream );
+
+        SMD_HASSERT( string::npos != stream.str().find( "\"name\":\"also-gone\"" ) );
+    }
+    testPassed();
+
+    testName = "Frees the names no span refers to and records the thread of every span";
+    {
+        profiler_c testObject( 2 );
+
+        testObject.mRecord( "a", "node", 0, 1 );
+        testObject.mRecord( "b", "node", 1, 2 );
+        testObject.mRecord( "b", "node", 2, 3 );
+        SMD_HASSERT( 1 == testObject.mcGetNumNames() );
+
+        for ( int iName = 0; iName < 100; ++iName ) {
+            testObject.mRecord( to_string( iName ), "node", iName, iName + 1 );
+        }
+        SMD_HASSERT( 2 == testObject.mcGetNumNames() && "99" == *testObject.mcGetSpan( 1 ).pName );
+
+        uint32_t otherId { 0 };
+        thread( [ & ]{
+            testObject.mRecord( "worker", "node", 0, 1 );
+            otherId = profiler_c::mGetThreadId();
+        } ).join();
+
+        SMD_HASSERT( otherId != profiler_c::mGetThreadId() );
+        SMD_HASSERT( otherId == testObject.mcGetSpan( 1 ).threadId );
+        SMD_HASSERT( profiler_c::mGetThreadId() == testObject.mcGetSpan( 0 ).threadId );
+
+        testObject.mClear();
+        SMD_HASSERT( 0 == testObject.mcGetNumNames() );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtMutation( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtMutation: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    vector< string > trace;
+
+    auto action = [ &trace ]( const string& cName, status_t status ) {
+        return [ &trace, cName, status ]( timeData_t ) { trace.emplace_back( cName ); return status; };
+    };
+
+    testName = "Inserts, removes, replaces and moves children";
+    {
+        auto pTree = builder_t()
+            .mSequence( "some-sequence" )
+                .mDo( "a", action( "a", status_t::SUCCESS ) )
+                .mDo( "b", action( "b", status_t::SUCCESS ) )
+            .mEnd()
+            .mBuild();
+
+        auto& sequence = static_cast< sequenceNode_t& >( *pTree->mGetRoot() );
+
+        pTree->mInsertChild( sequence, 1, pTree->mCreate< actionNode_t >( "c", action( "c", status_t::SUCCESS ) ) );
+        pTree->mTick( 0.1f );
+        SMD_HASSERT( ( vector< string > { "a", "c", "b" } ) == trace );
+        SMD_HASSERT( 4 == pTree->mcGetNumNodes() );
+
+        pTree->mRemoveChild( sequence, 0 );
+        pTree->mMoveChild( sequence, 1, 0 );
+        trace.clear();
+        pTree->mTick( 0.1f );
+        SMD_HASSERT( ( vector< string > { "b", "c" } ) == trace );
+        SMD_HASSERT( 3 == pTree->mcGetNumNodes() );
+
+        auto pSelector = pTree->mCreate< selectorNode_t >( "some-selector" );
+        pSelector->mAddChild( pTree->mCreate< actionNode_t >( "d", action( "d", status_t::FAILURE ) ) );
+        pSelector->mAddChild( pTree->mCreate< actionNode_t >( "e", action( "e", status_t::SUCCESS ) ) );
+
+        pTree->mReplaceChild( sequence, 0, pSelector );
+        trace.clear();
+        pTree->mTick( 0.1f );
+        SMD_HASSERT( ( vector< string > { "d", "e", "c" } ) == trace );
+        SMD_HASSERT( 5 == pTree->mcGetNumNodes() );
+    }
+    testPassed();
+
+    testName = "Cant edit children that dont exist or remove the last one";
+    {
+        auto pTree = builder_t().mSequence( "some-sequence" ).mDo( "a", action( "a", status_t::SUCCESS ) ).mEnd().mBuild();
+
+        auto& sequence = static_cast< sequenceNode_t& >( *pTree->mGetRoot() );
+
+        SMD_CHK_EXCEPT_CT( pTree->mRemoveChild( sequence, 0 ) );
+        SMD_CHK_EXCEPT_CT( pTree->mRemoveChild( sequence, 1 ) );
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( sequence, 2, pTree->mCreate< actionNode_t >( "b", action( "b", status_t::SUCCESS ) ) ) );
+        SMD_CHK_EXCEPT_CT( pTree->mReplaceChild( sequence, 0, nullptr ) );
+        SMD_CHK_EXCEPT_CT( pTree->mMoveChild( sequence, 0, 1 ) );
+    }
+    testPassed();
+
+    testName = "Edits only attach detached nodes of the tree and destroy children that cant be attached";
+    {
+        auto pTree  = builder_t().mSequence( "some-sequence" ).mDo( "a", action( "a", status_t::SUCCESS ) ).mEnd().mBuild();
+        auto pOther = builder_t().mSequence( "other-sequence" ).mDo( "x", action( "x", status_t::SUCCESS ) ).mEnd().mBuild();
+
+        auto& sequence = static_cast< sequenceNode_t& >( *pTree->mGetRoot() );
+        auto& other    = static_cast< sequenceNode_t& >( *pOther->mGetRoot() );
+
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( sequence, 0, pOther->mCreate< actionNode_t >( "b", action( "b", status_t::SUCCESS ) ) ) );
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( other, 0, pTree->mCreate< actionNode_t >( "b", action( "b", status_t::SUCCESS ) ) ) );
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( sequence, 0, sequence.mcGetChild( 0 ) ) );
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( sequence, 0, &sequence ) );
+
+        auto pInverter = pTree->mCreate< inverterNode_t >( "some-inverter" );
+        auto pChild    = pTree->mCreate< actionNode_t >( "c", action( "c", status_t::SUCCESS ) );
+        pInverter->mAddChild( pChild );
+
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( sequence, 0, pChild ) );
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( *pInverter, 0, &sequence ) );
+
+        pTree->mInsertChild( sequence, 1, pInverter );
+        SMD_CHK_EXCEPT_CT( pTree->mReplaceChild( sequence, 1, pChild ) );
+        SMD_HASSERT( pTree->mGetNode( pChild->mcGetId() ) == pChild );
+
+        const size_t cNumNodes { pTree->mcGetNumNodes() };
+        auto         pFull     = pTree->mCreate< actionNode_t >( "d", action( "d", status_t::SUCCESS ) );
+        const auto   cFullId   { pFull->mcGetId() };
+        SMD_CHK_EXCEPT_CT( pTree->mInsertChild( *pInverter, 0, pFull ) );
+        SMD_HASSERT( cNumNodes == pTree->mcGetNumNodes() );
+        SMD_HASSERT( !pTree->mGetNode( cFullId ) );
+
+        auto pMissing = pTree->mCreate< actionNode_t >( "e", action( "e", status_t::SUCCESS ) );
+        SMD_CHK_EXCEPT_CT( pTree->mReplaceChild( sequence, 5, pMissing ) );
+        SMD_HASSERT( cNumNodes == pTree->mcGetNumNodes() );
+
+        trace.clear();
+        pTree->mTick( 0.1f );
+        SMD_HASSERT( ( vector< string > { "a", "c" } ) == trace );
+    }
+    testPassed();
+
+    testName = "Instances keep the state of the nodes that werent edited";
+    {
+        shared_ptr< tree_t > pTree = builder_t()
+            .mSelector( "agent" )
+                .mSequence( "patrol" )
+                    .mCondition( "is-alerted", []( timeData_t ) { return true; } )
+                    .mDo( "walk", []( timeData_t ) { return status_t::RUNNING; } )
+                .mEnd()
+            .mEnd()
+            .mBuild();
+
+        auto& selector       = static_cast< selectorNode_t& >( *pTree->mGetRoot() );
+        const auto& cPatrol  = static_cast< const sequenceNode_t& >( *selector.mcGetChildren().front() );
+        const uint32_t cSize { pTree->mcGetStateSize() };
+
+        instance_t testObject( pTree );
+        testObject.mTick( 0.1f );
+
+        pTree->mInsertChild( selector, 1, pTree->mCreate< actionNode_t >( "idle", action( "idle", status_t::SUCCESS ) ) );
+        testObject.mSync();
+
+        tickContext_t< timeData_t > context { 0.0f, testObject.mGetState() };
+
+        SMD_HASSERT( cSize == pTree->mcGetStateSize() );
+        SMD_HASSERT( selectorNode_t::cNoChild == selector.mcGetRunningChild( context ) );
+        SMD_HASSERT( 1 == cPatrol.mcGetRunningChild( context ) );
+
+        auto pSequence = pTree->mCreate< sequenceNode_t >( "guard" );
+        pSequence->mAddChild( pTree->mCreate< actionNode_t >( "wait", action( "wait", status_t::RUNNING ) ) );
+        pTree->mReplaceChild( selector, 0, pSequence );
+
+        SMD_HASSERT( cSize + 8 == pTree->mcGetStateSize() );
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 3 == testObject.mcGetNumWords() );
+        SMD_HASSERT( 0 == pSequence->mcGetRunningChild( context = { 0.0f, testObject.mGetState() } ) );
+
+        pTree->mCompact();
+        SMD_HASSERT( cSize == pTree->mcGetStateSize() );
+        testObject.mSync();
+        SMD_HASSERT( 2 == testObject.mcGetNumWords() );
+        SMD_HASSERT( all_of( testObject.mcGetState(), testObject.mcGetState() + cSize, []( uint8_t byte ) { return byte == 0; } ) );
+    }
+    testPassed();
+
+    testName = "A tick that can't allocate the grown state fails and syncs on the next one";
+    {
+        shared_ptr< tree_t > pTree = builder_t()
+            .mSelector( "some-selector" )
+                .mDo( "a", action( "a", status_t::SUCCESS ) )
+            .mEnd()
+            .mBuild();
+
+        bool isOut { false };
+
+        instance_c< timeData_t, failingAllocator_t< stateWord_t > > testObject( pTree, failingAllocator_t< stateWord_t >( &isOut ) );
+
+        auto pSequence = pTree->mCreate< sequenceNode_t >( "guard" );
+        pSequence->mAddChild( pTree->mCreate< actionNode_t >( "wait", action( "wait", status_t::RUNNING ) ) );
+        pTree->mInsertChild( static_cast< selectorNode_t& >( *pTree->mGetRoot() ), 0, pSequence );
+
+        isOut = true;
+        SMD_HASSERT( status_t::FAILURE == testObject.mTick( 0.1f ) );
+
+        isOut = false;
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( pTree->mcGetStateSize() == testObject.mcGetStateSize() );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtNodeIndex( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtNodeIndex: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    auto build = []{
+        return builder_t()
+            .mSelector( "agent" )
+                .mSequence( "patrol" )
+                    .mCondition( "is-calm", []( timeData_t ) { return true; } )
+                    .mDo( "walk", []( timeData_t ) { return status_t::RUNNING; } )
+                .mEnd()
+                .mDo( "walk", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mEnd()
+            .mBuild();
+    };
+
+    testName = "Builder assigns ids in the order of the nodes";
+    {
+        auto pTree1 = build();
+        auto pTree2 = build();
+
+        SMD_HASSERT( 0 == pTree1->mcGetRoot()->mcGetId() );
+        SMD_HASSERT( "is-calm" == pTree1->mcGetNode( 2 )->mcName );
+        SMD_HASSERT( "walk" == pTree1->mcGetNode( 4 )->mcName && nodeKind_t::ACTION == pTree1->mcGetNode( 4 )->mcKind );
+        SMD_HASSERT( nullptr == pTree1->mcGetNode( 5 ) );
+
+        for ( uint32_t id = 0; id < pTree1->mcGetNumNodes(); ++id ) {
+            SMD_HASSERT( id == pTree1->mcGetNode( id )->mcGetId() );
+            SMD_HASSERT( pTree1->mcGetNode( id )->mcName == pTree2->mcGetNode( id )->mcName );
+        }
+    }
+    testPassed();
+
+    testName = "Finds nodes by paths and names";
+    {
+        auto pTree = build();
+
+        SMD_HASSERT( pTree->mcGetRoot() == pTree->mcFind( "agent" ) );
+        SMD_HASSERT( pTree->mcGetNode( 3 ) == pTree->mcFind( "agent/patrol/walk" ) );
+        SMD_HASSERT( pTree->mcGetNode( 4 ) == pTree->mFind( "agent/walk" ) );
+        SMD_HASSERT( pTree->mcGetNode( 3 ) == pTree->mcFindByName( "walk" ) );
+        SMD_HASSERT( nullptr == pTree->mcFind( "agent/patrol/run" ) && nullptr == pTree->mcFindByName( "run" ) );
+    }
+    testPassed();
+
+    testName = "Edits keep ids and update the paths";
+    {
+        auto pTree = build();
+
+        auto& patrol = static_cast< sequenceNode_t& >( *pTree->mFind( "agent/patrol" ) );
+
+        pTree->mInsertChild( patrol, 1, pTree->mCreate< actionNode_t >( "look", []( timeData_t ) { return status_t::SUCCESS; } ) );
+        pTree->mRemoveChild( patrol, 0 );
+
+        SMD_HASSERT( nullptr == pTree->mcGetNode( 2 ) && nullptr == pTree->mcFind( "agent/patrol/is-calm" ) );
+        SMD_HASSERT( pTree->mcGetNode( 5 ) == pTree->mcFind( "agent/patrol/look" ) );
+        SMD_HASSERT( pTree->mcGetNode( 3 ) == pTree->mcFind( "agent/patrol/walk" ) );
+    }
+    testPassed();
+
+    testName = "Inserted nodes come first when they come first in pre-order";
+    {
+        auto pTree = build();
+
+        auto& root = static_cast< selectorNode_t& >( *pTree->mFind( "agent" ) );
+
+        pTree->mInsertChild( root, 0, pTree->mCreate< actionNode_t >( "walk", []( timeData_t ) { return status_t::FAILURE; } ) );
+
+        SMD_HASSERT( 6 == pTree->mcGetNumNodes() );
+        SMD_HASSERT( pTree->mcGetNode( 5 ) == pTree->mcFindByName( "walk" ) );
+        SMD_HASSERT( pTree->mcGetNode( 5 ) == pTree->mcFind( "agent/walk" ) );
+
+        pTree->mRemoveChild( root, 0 );
+
+        SMD_HASSERT( pTree->mcGetNode( 3 ) == pTree->mcFindByName( "walk" ) );
+        SMD_HASSERT( pTree->mcGetNode( 4 ) == pTree->mcFind( "agent/walk" ) );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtTraversal( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtTraversal: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    shared_ptr< const tree_t > pFlee = builder_t()
+        .mSequence( "flee" )
+            .mDo( "run-away", []( timeData_t ) { return status_t::RUNNING; } )
+        .mEnd()
+        .mBuild();
+
+    auto pTree = builder_t()
+        .mSelector( "agent" )
+            .mInverter( "not" )
+                .mCondition( "is-calm", []( timeData_t ) { return true; } )
+            .mEnd()
+            .mSplice( pFlee )
+            .mDo( "idle", []( timeData_t ) { return status_t::SUCCESS; } )
+        .mEnd()
+        .mBuild();
+
+    testName = "Accesses children of any node";
+    {
+        const node_i< timeData_t >& cRoot = *pTree->mcGetRoot();
+
+        SMD_HASSERT( 3 == cRoot.mcGetNumChildren() );
+        SMD_HASSERT( "not" == cRoot.mcGetChild( 0 )->mcName );
+        SMD_HASSERT( 1 == cRoot.mcGetChild( 0 )->mcGetNumChildren() );
+        SMD_HASSERT( 0 == cRoot.mcGetChild( 2 )->mcGetNumChildren() && cRoot.mcGetChild( 2 )->mcGetChildren().empty() );
+        SMD_HASSERT( pFlee->mcGetRoot() == cRoot.mcGetChild( 1 )->mcGetChild( 0 ) );
+    }
+    testPassed();
+
+    testName = "Visits nodes in pre-order with their depths";
+    {
+        string visited;
+
+        pTree->mcGetRoot()->mcVisit( [ &visited ]( const node_i< timeData_t >& cNode, uint32_t depth ) {
+            visited += to_string( depth ) + cNode.mcName + ' ';
+            return true;
+        } );
+
+        SMD_HASSERT( "0agent 1not 2is-calm 1flee 2flee 3run-away 1idle " == visited );
+    }
+    testPassed();
+
+    testName = "Visitor decides whether to descend";
+    {
+        uint32_t numVisited { 0 };
+
+        pTree->mGetRoot()->mVisit( [ &numVisited ]( node_i< timeData_t >& node, uint32_t ) {
+            ++numVisited;
+            return node.mcKind != nodeKind_t::SUBTREE && node.mcKind != nodeKind_t::INVERTER;
+        } );
+
+        SMD_HASSERT( 4 == numVisited );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtReactiveSelector( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtReactiveSelector: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    bool         isEnemyVisible { false };
+    map< string, uint32_t > counts;
+
+    auto condition = [ & ]( const string& cName, const bool& cValue ) {
+        return [ &counts, &cValue, cName ]( timeData_t ) { ++counts[ cName ]; return cValue; };
+    };
+    auto action = [ & ]( const string& cName, status_t status ) {
+        return [ &counts, cName, status ]( timeData_t ) { ++counts[ cName ]; return status; };
+    };
+
+    const bool cTrue { true };
+
+    shared_ptr< const tree_t > pTree = builder_t()
+        .mReactiveSelector( "combat" )
+            .mSequence( "attack" )
+                .mCondition( "is-enemy-visible", condition( "is-enemy-visible", isEnemyVisible ) )
+                .mDo( "aim", action( "aim", status_t::SUCCESS ) )
+                .mDo( "shoot", action( "shoot", status_t::RUNNING ) )
+            .mEnd()
+            .mSequence( "patrol" )
+                .mCondition( "is-calm", condition( "is-calm", cTrue ) )
+                .mDo( "go-to-waypoint", action( "go-to-waypoint", status_t::SUCCESS ) )
+                .mDo( "walk", action( "walk", status_t::RUNNING ) )
+            .mEnd()
+        .mEnd()
+        .mBuild();
+
+    const auto& cCombat = static_cast< const reactiveSelectorNode_c< timeData_t >& >( *pTree->mcGetRoot() );
+    const auto& cAttack = static_cast< const sequenceNode_t& >( *pTree->mcFind( "combat/attack" ) );
+    const auto& cPatrol = static_cast< const sequenceNode_t& >( *pTree->mcFind( "combat/patrol" ) );
+
+    instance_t                  testObject( pTree );
+    tickContext_t< timeData_t > context { 0.0f, testObject.mGetState() };
+
+    testName = "Resumes the running branch checking only the guards above it";
+    {
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+
+        SMD_HASSERT( 1 == cCombat.mcGetRunningChild( context ) );
+        SMD_HASSERT( 2 == counts[ "is-enemy-visible" ] && 0 == counts[ "aim" ] );
+        SMD_HASSERT( 2 == counts[ "is-calm" ] && 1 == counts[ "go-to-waypoint" ] && 2 == counts[ "walk" ] );
+    }
+    testPassed();
+
+    testName = "Aborts the running branch when a higher guard passes";
+    {
+        isEnemyVisible = true;
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 0 == cCombat.mcGetRunningChild( context ) );
+        SMD_HASSERT( sequenceNode_t::cNoChild == cPatrol.mcGetRunningChild( context ) );
+        SMD_HASSERT( 2 == cAttack.mcGetRunningChild( context ) );
+        SMD_HASSERT( 3 == counts[ "is-enemy-visible" ] && 1 == counts[ "aim" ] && 1 == counts[ "shoot" ] );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 4 == counts[ "is-enemy-visible" ] && 1 == counts[ "aim" ] && 2 == counts[ "shoot" ] );
+        SMD_HASSERT( 2 == counts[ "walk" ] );
+    }
+    testPassed();
+
+    testName = "Falls back to lower branches when the running guard fails";
+    {
+        isEnemyVisible = false;
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 1 == cCombat.mcGetRunningChild( context ) );
+        SMD_HASSERT( sequenceNode_t::cNoChild == cAttack.mcGetRunningChild( context ) );
+        SMD_HASSERT( 2 == counts[ "go-to-waypoint" ] && 3 == counts[ "walk" ] );
+    }
+    testPassed();
+
+    testName = "Ticks branches without guards as a whole";
+    {
+        uint32_t numTicked { 0 };
+
+        shared_ptr< const tree_t > pUnguarded = builder_t()
+            .mReactiveSelector( "some-selector" )
+                .mDo( "some-action", [ & ]( timeData_t ) { ++numTicked; return status_t::FAILURE; } )
+                .mDo( "other-action", []( timeData_t ) { return status_t::RUNNING; } )
+            .mEnd()
+            .mBuild();
+
+        instance_t instance( pUnguarded );
+
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        SMD_HASSERT( 2 == numTicked );
+        SMD_CHK_EXCEPT_CT( codegen_c< timeData_t >().mEmit( *pUnguarded->mcGetRoot(), "tickTree" ) );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtTickContext( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtTickContext: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    testName = "Passes small time data by value and large time data by reference";
+    {
+        static_assert( std::is_same_v< float, param_t< float > > );
+        static_assert( std::is_same_v< const frame_t&, param_t< frame_t > > );
+    }
+    testPassed();
+
+    struct agent_t final {
+        uint32_t numAttacks { 0 };
+    };
+
+    shared_ptr< const tree_c< frame_t > > pTree = builder_c< frame_t >()
+        .mSequence( "agent" )
+            .mCondition( "is-moving", []( const frame_t& cFrame ) { return cFrame.timeDelta > 0.0f; } )
+            .mDo( "attack", []( const tickContext_t< frame_t >& cContext ) {
+                ++static_cast< agent_t* >( cContext.pAgent )->numAttacks;
+                return cContext.timeData.timeDelta > 0.2f ? status_t::SUCCESS : status_t::RUNNING;
+            } )
+        .mEnd()
+        .mBuild();
+
+    testName = "Ticks a tree without copying the time data";
+    {
+        const frame_t cFrame { 0.1f };
+
+        frame_t::numCopies = 0;
+
+        agent_t               agent;
+        instance_c< frame_t > testObject( pTree );
+        testObject.mSetAgent( &agent );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( cFrame ) );
+        SMD_HASSERT( 0 == frame_t::numCopies && 1 == agent.numAttacks );
+    }
+    testPassed();
+
+    testName = "Context-aware leaves reach the agent of their instance";
+    {
+        vector< agent_t >               agents( 3 );
+        vector< instance_c< frame_t > > instances( agents.size(), instance_c< frame_t >( pTree ) );
+
+        for ( size_t iAgent = 0; iAgent < agents.size(); ++iAgent ) {
+            instances[ iAgent ].mSetAgent( &agents[ iAgent ] );
+            SMD_HASSERT( &agents[ iAgent ] == instances[ iAgent ].mcGetAgent() );
+        }
+
+        frame_t::numCopies = 0;
+
+        parallelTicker_c< frame_t, uint32_t > ticker( 2 );
+        ticker.mTick( instances.data(), instances.size(), frame_t { 0.1f } );
+        instances[ 1 ].mTick( frame_t { 0.3f } );
+
+        SMD_HASSERT( 0 == frame_t::numCopies );
+        SMD_HASSERT( 1 == agents[ 0 ].numAttacks && 2 == agents[ 1 ].numAttacks && 1 == agents[ 2 ].numAttacks );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtActivePath( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtActivePath: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    constexpr uint32_t cDepth { 20 };
+
+    map< string, uint32_t > counts;
+    map< string, status_t > results;
+
+    auto leaf = [ & ]( const string& cName ) {
+        results[ cName ] = status_t::SUCCESS;
+        return [ &counts, &results, cName ]( timeData_t ) { ++counts[ cName ]; return results[ cName ]; };
+    };
+
+    auto buildQuest = [ & ]( bool hasMemory ) {
+        builder_t builder;
+
+        for ( uint32_t depth = 0; depth < cDepth; ++depth ) {
+            builder.mSequence( "step-" + to_string( depth ) );
+        }
+
+        builder.mDo( "prepare", leaf( "prepare" ) )
+               .mDo( "travel", leaf( "travel" ) )
+               .mDo( "arrive", leaf( "arrive" ) );
+
+        for ( uint32_t depth = 0; depth < cDepth; ++depth ) {
+            builder.mEnd();
+        }
+
+        auto pTree = builder.mBuild();
+        pTree->mSetMemory( hasMemory );
+
+        return shared_ptr< const tree_t >( move( pTree ) );
+    };
+
+    testName = "Resumes at the running leaf without descending from the root";
+    {
+        instance_t testObject( buildQuest( true ) );
+        profiler_c profiler( 64 );
+
+        results[ "travel" ] = status_t::RUNNING;
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f, &profiler ) );
+        SMD_HASSERT( cDepth + 1 == profiler.mcGetNumSpans() );
+
+        profiler.mClear();
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f, &profiler ) );
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f, &profiler ) );
+        SMD_HASSERT( 2 == profiler.mcGetNumSpans() );
+        SMD_HASSERT( 1 == counts[ "prepare" ] && 3 == counts[ "travel" ] && 0 == counts[ "arrive" ] );
+    }
+    testPassed();
+
+    testName = "Unwinds upward when the running leaf finishes";
+    {
+        shared_ptr< const tree_t > pTree = buildQuest( true );
+        instance_t                 testObject( pTree );
+
+        counts.clear();
+        results[ "travel" ] = status_t::RUNNING;
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+
+        results[ "travel" ] = status_t::SUCCESS;
+
+        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 1 == counts[ "prepare" ] && 2 == counts[ "travel" ] && 1 == counts[ "arrive" ] );
+
+        tickContext_t< timeData_t > context { 0.0f, testObject.mGetState() };
+        pTree->mcGetRoot()->mcVisit( [ & ]( const node_i< timeData_t >& cNode, uint32_t ) {
+            SMD_HASSERT( cNode.mcKind != nodeKind_t::SEQUENCE
+                || sequenceNode_t::cNoChild == static_cast< const sequenceNode_t& >( cNode ).mcGetRunningChild( context ) );
+            return true;
+        } );
+
+        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 2 == counts[ "prepare" ] && 3 == counts[ "travel" ] && 2 == counts[ "arrive" ] );
+    }
+    testPassed();
+
+    testName = "Ticks from the root without memory";
+    {
+        instance_t testObject( buildQuest( false ) );
+
+        counts.clear();
+        results[ "travel" ] = status_t::RUNNING;
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 2 == counts[ "prepare" ] && 2 == counts[ "travel" ] );
+    }
+    testPassed();
+
+    testName = "Resumes within spliced sub-trees and selectors";
+    {
+        library_t library;
+        library.mDefine( "patrol", builder_t()
+            .mSequence( "patrol" )
+                .mDo( "walk-to-a", leaf( "walk-to-a" ) )
+                .mDo( "walk-to-b", leaf( "walk-to-b" ) )
+            .mEnd()
+            .mBuild() );
+
+        auto pTree = builder_t()
+            .mSelector( "agent" )
+                .mSequence( "fight" )
+                    .mCondition( "is-enemy-visible", [ & ]( timeData_t ) { ++counts[ "is-enemy-visible" ]; return false; } )
+                    .mDo( "attack", leaf( "attack" ) )
+                .mEnd()
+                .mInverter( "not" )
+                    .mInverter( "not" )
+                        .mSplice( library, "patrol" )
+                    .mEnd()
+                .mEnd()
+            .mEnd()
+            .mBuild();
+        pTree->mSetMemory( true );
+
+        counts.clear();
+        results[ "walk-to-a" ] = status_t::RUNNING;
+        results[ "walk-to-b" ] = status_t::RUNNING;
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( 1 == counts[ "is-enemy-visible" ] && 2 == counts[ "walk-to-a" ] );
+
+        results[ "walk-to-a" ] = status_t::SUCCESS;
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( 1 == counts[ "is-enemy-visible" ] && 3 == counts[ "walk-to-a" ] && 2 == counts[ "walk-to-b" ] );
+
+        results[ "walk-to-b" ] = status_t::SUCCESS;
+
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( 2 == counts[ "is-enemy-visible" ] && 4 == counts[ "walk-to-a" ] && 4 == counts[ "walk-to-b" ] );
+    }
+    testPassed();
+
+    testName = "Ticks from the root through composites without memory";
+    {
+        auto pTree = builder_t()
+            .mParallel( "agent", 1, 1 )
+                .mSequence( "quest" )
+                    .mDo( "prepare", leaf( "prepare" ) )
+                    .mDo( "travel", leaf( "travel" ) )
+                .mEnd()
+            .mEnd()
+            .mBuild();
+        pTree->mSetMemory( true );
+
+        counts.clear();
+        results[ "travel" ] = status_t::RUNNING;
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( 2 == counts[ "prepare" ] && 2 == counts[ "travel" ] );
+    }
+    testPassed();
+
+    testName = "Finds the running leaf again after a restore";
+    {
+        shared_ptr< const tree_t > pTree = buildQuest( true );
+        instance_t                 testObject( pTree );
+        vector< stateWord_t >      snapshot( testObject.mcGetNumWords() );
+
+        counts.clear();
+        results[ "prepare" ] = status_t::RUNNING;
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        testObject.mcSnapshot( snapshot.data() );
+
+        results[ "prepare" ] = status_t::SUCCESS;
+        results[ "travel" ]  = status_t::RUNNING;
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 2 == counts[ "prepare" ] && 1 == counts[ "travel" ] );
+
+        testObject.mRestore( snapshot.data() );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 3 == counts[ "prepare" ] && 2 == counts[ "travel" ] );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtScheduler( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtScheduler: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    constexpr uint32_t cAlarm   { 7 };
+    constexpr uint32_t cSunrise { 8 };
+
+    uint32_t numLookArounds { 0 };
+    uint32_t numResponses   { 0 };
+
+    shared_ptr< const tree_t > pTree = builder_t()
+        .mSequence( "guard" )
+            .mDo( "look-around", [ & ]( timeData_t ) { ++numLookArounds; return status_t::SUCCESS; } )
+            .mWait( "wait-for-alarm", cAlarm )
+            .mDo( "respond", [ & ]( timeData_t ) { ++numResponses; return status_t::SUCCESS; } )
+        .mEnd()
+        .mBuild();
+
+    vector< instance_t >     instances( 100, instance_t( pTree ) );
+    scheduler_c< timeData_t > testObject;
+
+    for ( auto& instance : instances ) {
+        testObject.mAdd( instance );
+    }
+
+    testName = "Doesn't tick agents that wait for an event";
+    {
+        testObject.mTick( 0.1f );
+
+        SMD_HASSERT( 0 == testObject.mcGetNumAwake() && 100 == testObject.mcGetNumAgents() );
+        SMD_HASSERT( !testObject.mcIsAwake( 0 ) && status_t::RUNNING == testObject.mcGetStatus( 0 ) );
+
+        testObject.mTick( 0.1f );
+        testObject.mTick( 0.1f );
+
+        SMD_HASSERT( 100 == numLookArounds && 0 == numResponses );
+    }
+    testPassed();
+
+    testName = "Wakes up the agents waiting for a signalled event";
+    {
+        testObject.mSignal( cSunrise );
+        SMD_HASSERT( 0 == testObject.mcGetNumAwake() );
+
+        testObject.mSignal( cAlarm );
+        SMD_HASSERT( 100 == testObject.mcGetNumAwake() && testObject.mcIsAwake( 99 ) );
+
+        testObject.mTick( 0.1f );
+
+        SMD_HASSERT( 200 == numLookArounds && 100 == numResponses );
+        SMD_HASSERT( 100 == testObject.mcGetNumAwake() && status_t::SUCCESS == testObject.mcGetStatus( 99 ) );
+
+        testObject.mTick( 0.1f );
+
+        SMD_HASSERT( 300 == numLookArounds && 0 == testObject.mcGetNumAwake() );
+    }
+    testPassed();
+
+    testName = "Wakes up the agents waiting for events added after they were";
+    {
+        auto build = []( const string& cName ) -> shared_ptr< tree_t > {
+            return builder_t()
+                .mSequence( cName )
+                    .mDo( "step", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+                .mBuild();
+        };
+
+        shared_ptr< tree_t > pNorth = build( "north" );
+        shared_ptr< tree_t > pSouth = build( "south" );
+
+        vector< instance_t >      agents { instance_t( pNorth ), instance_t( pSouth ), instance_t( pNorth ) };
+        scheduler_c< timeData_t > scheduler;
+
+        for ( auto& agent : agents ) {
+            scheduler.mAdd( agent );
+        }
+
+        pNorth->mInsertChild( static_cast< sequenceNode_t& >( *pNorth->mGetRoot() ), 1,
+                              pNorth->mCreate< waitNode_c< timeData_t > >( "wait-north", 9u ) );
+        pSouth->mInsertChild( static_cast< sequenceNode_t& >( *pSouth->mGetRoot() ), 1,
+                              pSouth->mCreate< waitNode_c< timeData_t > >( "wait-south", 10u ) );
+
+        scheduler.mTick( 0.1f );
+        SMD_HASSERT( 0 == scheduler.mcGetNumAwake() );
+
+        scheduler.mSignal( 9 );
+        SMD_HASSERT( 2 == scheduler.mcGetNumAwake() && scheduler.mcIsAwake( 0 ) && !scheduler.mcIsAwake( 1 ) );
+
+        scheduler.mTick( 0.1f );
+        SMD_HASSERT( status_t::SUCCESS == scheduler.mcGetStatus( 0 ) && status_t::SUCCESS == scheduler.mcGetStatus( 2 ) );
+
+        scheduler.mSignal( 10 );
+        scheduler.mTick( 0.1f );
+        SMD_HASSERT( status_t::SUCCESS == scheduler.mcGetStatus( 1 ) );
+    }
+    testPassed();
+
+    testName = "Keeps running without a scheduler";
+    {
+        instance_t instance( pTree );
+
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        SMD_HASSERT( 100 == numResponses );
+    }
+    testPassed();
+
+    testName = "Can't generate code for a wait node";
+    {
+        SMD_CHK_EXCEPT_CT( codegen_c< timeData_t >().mEmit( *pTree->mcGetRoot(), "tickTree" ) );
+        SMD_CHK_EXCEPT_CT( builder_t().mSequence( "some-sequence" ).mWait( "some-wait", cNoEvent ) );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtTimeSlice( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtTimeSlice: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    map< string, uint32_t > counts;
+
+    auto leaf = [ & ]( const string& cName, status_t status ) {
+        return [ &counts, cName, status ]( timeData_t ) { ++counts[ cName ]; return status; };
+    };
+
+    testName = "Suspends after the visits of the budget and resumes where it stopped";
+    {
+        builder_t builder;
+        builder.mSequence( "plan" );
+        for ( uint32_t iStep = 0; iStep < 10; ++iStep ) {
+            builder.mDo( "step-" + to_string( iStep ), leaf( "step-" + to_string( iStep ), status_t::SUCCESS ) );
+        }
+        auto pTree = builder.mEnd().mBuild();
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f, tickBudget_t { 3 } ) && pTree->mcIsSuspended() );
+        SMD_HASSERT( 1 == counts[ "step-3" ] && 0 == counts[ "step-4" ] );
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f, tickBudget_t { 3 } ) && pTree->mcIsSuspended() );
+        SMD_HASSERT( 1 == counts[ "step-4" ] && 1 == counts[ "step-7" ] && 0 == counts[ "step-8" ] );
+
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 0.1f, tickBudget_t { 3 } ) && !pTree->mcIsSuspended() );
+
+        for ( uint32_t iStep = 0; iStep < 10; ++iStep ) {
+            SMD_HASSERT( 1 == counts[ "step-" + to_string( iStep ) ] );
+        }
+
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( 2 == counts[ "step-0" ] && 2 == counts[ "step-9" ] );
+    }
+    testPassed();
+
+    shared_ptr< const tree_t > pTree = builder_t()
+        .mSequence( "agent" )
+            .mSelector( "find-target" )
+                .mDo( "find-enemy", leaf( "find-enemy", status_t::FAILURE ) )
+                .mDo( "find-prey", leaf( "find-prey", status_t::FAILURE ) )
+                .mSequence( "search" )
+                    .mDo( "look-around", leaf( "look-around", status_t::SUCCESS ) )
+                    .mDo( "pick-closest", leaf( "pick-closest", status_t::SUCCESS ) )
+                .mEnd()
+            .mEnd()
+            .mInverter( "not" )
+                .mDo( "is-blocked", leaf( "is-blocked", status_t::FAILURE ) )
+            .mEnd()
+            .mDo( "walk", leaf( "walk", status_t::RUNNING ) )
+        .mEnd()
+        .mBuild();
+
+    testName = "Gives the same result as a whole tick";
+    {
+        counts.clear();
+
+        instance_t testObject( pTree );
+        uint32_t   numTicks { 0 };
+        status_t   status;
+
+        do {
+            status = testObject.mTick( 0.1f, tickBudget_t { 1 } );
+            ++numTicks;
+        } while ( testObject.mcIsSuspended() );
+
+        SMD_HASSERT( status_t::RUNNING == status && 3 == numTicks );
+        SMD_HASSERT( 6 == counts.size() && all_of( counts.begin(), counts.end(), []( const auto& cCount ) {
+            return 1 == cCount.second;
+        } ) );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 2 == counts[ "find-enemy" ] && 2 == counts[ "walk" ] );
+    }
+    testPassed();
+
+    testName = "Finishes a suspended traversal with a whole tick";
+    {
+        counts.clear();
+
+        instance_t testObject( pTree );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f, tickBudget_t { 0 } ) && testObject.mcIsSuspended() );
+        SMD_HASSERT( 1 == counts[ "find-enemy" ] && 0 == counts[ "find-prey" ] );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f ) && !testObject.mcIsSuspended() );
+        SMD_HASSERT( 1 == counts[ "find-enemy" ] && 1 == counts[ "find-prey" ] && 1 == counts[ "walk" ] );
+    }
+    testPassed();
+
+    testName = "Suspends after the time of the budget";
+    {
+        auto busyLeaf = [ & ]( timeData_t ) {
+            const auto cEnd = chrono::steady_clock::now() + chrono::microseconds( 200 );
+            while ( chrono::steady_clock::now() < cEnd ) {}
+            ++counts[ "busy" ];
+            return status_t::SUCCESS;
+        };
+
+        shared_ptr< const tree_t > pSlow = builder_t()
+            .mSequence( "plan" )
+                .mDo( "busy-1", busyLeaf )
+                .mDo( "busy-2", busyLeaf )
+                .mDo( "busy-3", busyLeaf )
+            .mEnd()
+            .mBuild();
+
+        counts.clear();
+
+        instance_t testObject( pSlow );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f, tickBudget_t { UINT32_MAX, 100 } ) );
+        SMD_HASSERT( 1 == counts[ "busy" ] && testObject.mcIsSuspended() );
+        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( 0.1f, tickBudget_t { UINT32_MAX, 1000 } ) );
+        SMD_HASSERT( 3 == counts[ "busy" ] );
+    }
+    testPassed();
+
+    testName = "Doesn't suspend the children of a parallel";
+    {
+        shared_ptr< const tree_t > pParallel = builder_t()
+            .mParallel( "agent", 1, 1 )
+                .mSequence( "plan" )
+                    .mDo( "step-1", leaf( "step-1", status_t::SUCCESS ) )
+                    .mDo( "step-2", leaf( "step-2", status_t::RUNNING ) )
+                .mEnd()
+            .mEnd()
+            .mBuild();
+
+        counts.clear();
+
+        instance_t testObject( pParallel );
+
+        SMD_HASSERT( status_t::RUNNING == testObject.mTick( 0.1f, tickBudget_t { 0 } ) && !testObject.mcIsSuspended() );
+        SMD_HASSERT( 1 == counts[ "step-1" ] && 1 == counts[ "step-2" ] );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtPartitionedTicker( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtPartitionedTicker: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    using emitter_t = parallelTicker_c< timeData_t, size_t >;
+    using ticker_t  = partitionedTicker_c< timeData_t, size_t >;
+
+    shared_ptr< const tree_t > pTree = builder_t()
+        .mSequence( "agent" )
+            .mDo( "report", []( timeData_t ) {
+                emitter_t::mEmit( emitter_t::mGetAgent() );
+                return status_t::SUCCESS;
+            } )
+            .mDo( "report-twice", []( timeData_t ) {
+                emitter_t::mEmit( emitter_t::mGetAgent() * 2 );
+                return status_t::RUNNING;
+            } )
+        .mEnd()
+        .mBuild();
+
+    testName = "Commands come in agent order regardless of the number of partitions";
+    {
+        vector< size_t > expected;
+        for ( size_t iAgent = 0; iAgent < 101; ++iAgent ) {
+            expected.emplace_back( iAgent );
+            expected.emplace_back( iAgent * 2 );
+        }
+
+        for ( uint32_t numPartitions : { 1, 2, 3, 8 } ) {
+            ticker_t testObject( numPartitions );
+
+            for ( size_t iAgent = 0; iAgent < 101; ++iAgent ) {
+                SMD_HASSERT( iAgent == testObject.mAdd( pTree ) );
+            }
+
+            SMD_HASSERT( nullptr == testObject.mcGetInstance( 0 ) );
+            SMD_HASSERT( expected == testObject.mTick( 0.1f ) );
+            SMD_HASSERT( expected == testObject.mTick( 0.1f ) );
+            SMD_HASSERT( expected == testObject.mcGetCommands() );
+            SMD_HASSERT( numPartitions == testObject.mcGetNumPartitions() );
+        }
+    }
+    testPassed();
+
+    testName = "Agents added between ticks join the next tick";
+    {
+        ticker_t testObject( 2 );
+
+        SMD_HASSERT( testObject.mTick( 0.1f ).empty() );
+
+        testObject.mAdd( pTree );
+        SMD_HASSERT( ( vector< size_t > { 0, 0 } ) == testObject.mTick( 0.1f ) );
+
+        testObject.mAdd( pTree );
+        testObject.mAdd( pTree );
+        SMD_HASSERT( ( vector< size_t > { 0, 0, 1, 2, 2, 4 } ) == testObject.mTick( 0.1f ) );
+        SMD_HASSERT( 3 == testObject.mcGetNumAgents() );
+    }
+    testPassed();
+
+    testName = "Instances and their state are placed in the arenas on separate cache lines";
+    {
+        ticker_t testObject( 3 );
+        int      agents[ 6 ] {};
+
+        for ( int& agent : agents ) {
+            testObject.mAdd( pTree, &agent );
+        }
+        testObject.mTick( 0.1f );
+
+        for ( uint32_t iPartition = 0; iPartition < 3; ++iPartition ) {
+            SMD_HASSERT( 0 < testObject.mcGetNumArenaBytes( iPartition ) );
+            SMD_HASSERT( 0 == testObject.mcGetNumArenaBytes( iPartition ) % arena_c::cLineSize );
+        }
+
+        for ( size_t iAgent = 0; iAgent < 6; ++iAgent ) {
+            const ticker_t::instance_t* cpInstance { testObject.mcGetInstance( iAgent ) };
+
+            SMD_HASSERT( cpInstance );
+            SMD_HASSERT( &agents[ iAgent ] == cpInstance->mcGetAgent() );
+            SMD_HASSERT( 0 == reinterpret_cast< uintptr_t >( cpInstance ) % arena_c::cLineSize );
+            SMD_HASSERT( 0 == reinterpret_cast< uintptr_t >( cpInstance->mcGetState() ) % arena_c::cLineSize );
+        }
+        SMD_HASSERT( nullptr == testObject.mcGetInstance( 6 ) );
+    }
+    testPassed();
+
+    testName = "Partitions are rebuilt in fresh arenas as edits regrow the state";
+    {
+        shared_ptr< tree_t > pEdited = builder_t()
+            .mSequence( "agent" )
+                .mDo( "report", []( timeData_t ) {
+                    emitter_t::mEmit( emitter_t::mGetAgent() );
+                    return status_t::SUCCESS;
+                } )
+            .mEnd()
+            .mBuild();
+
+        ticker_t testObject( 1 );
+        int      agents[ 8 ] {};
+
+        for ( int& agent : agents ) {
+            testObject.mAdd( pEdited, &agent );
+        }
+        testObject.mTick( 0.1f );
+
+        auto& root = static_cast< sequenceNode_t& >( *pEdited->mGetRoot() );
+
+        for ( int iEdit = 0; iEdit < 64; ++iEdit ) {
+            auto pSequence = pEdited->mCreate< sequenceNode_t >( "step" );
+            pSequence->mAddChild( pEdited->mCreate< actionNode_t >( "done", []( timeData_t ) { return status_t::SUCCESS; } ) );
+            pEdited->mInsertChild( root, root.mcGetNumChildren(), pSequence );
+
+            SMD_HASSERT( ( vector< size_t > { 0, 1, 2, 3, 4, 5, 6, 7 } ) == testObject.mTick( 0.1f ) );
+        }
+
+        const size_t cLines { ( sizeof( ticker_t::instance_t ) + arena_c::cLineSize - 1 ) / arena_c::cLineSize +
+                              ( pEdited->mcGetStateSize() + arena_c::cLineSize - 1 ) / arena_c::cLineSize };
+
+        SMD_HASSERT( testObject.mcGetNumArenaBytes( 0 ) < 2 * 8 * cLines * arena_c::cLineSize );
+
+        for ( size_t iAgent = 0; iAgent < 8; ++iAgent ) {
+            SMD_HASSERT( &agents[ iAgent ] == testObject.mcGetInstance( iAgent )->mcGetAgent() );
+            SMD_HASSERT( pEdited->mcGetStateSize() == testObject.mcGetInstance( iAgent )->mcGetStateSize() );
+        }
+    }
+    testPassed();
+
+    testName = "Arena";
+    {
+        arena_c testObject( 100 );
+
+        uint8_t* const cpFirst { static_cast< uint8_t* >( testObject.mAllocate( 1 ) ) };
+        uint8_t* const cpSecond { static_cast< uint8_t* >( testObject.mAllocate( 65 ) ) };
+        uint8_t* const cpLarge { static_cast< uint8_t* >( testObject.mAllocate( 1000 ) ) };
+
+        SMD_HASSERT( 0 == reinterpret_cast< uintptr_t >( cpFirst ) % arena_c::cLineSize );
+        SMD_HASSERT( 0 == reinterpret_cast< uintptr_t >( cpSecond ) % arena_c::cLineSize );
+        SMD_HASSERT( 0 == reinterpret_cast< uintptr_t >( cpLarge ) % arena_c::cLineSize );
+        SMD_HASSERT( 64 + 128 + 1024 == testObject.mcGetNumBytes() );
+
+        std::memset( cpLarge, 0, 1000 );
+
+        arenaAllocator_c< uint64_t >( testObject ).deallocate( reinterpret_cast< uint64_t* >( cpSecond ), 9 );
+        SMD_HASSERT( 128 == testObject.mcGetNumReleasedBytes() );
+    }
+    testPassed();
+
+    testName = "Cant tick on zero partitions or add an empty tree";
+    {
+        SMD_CHK_EXCEPT_CT( ticker_t( 0 ) );
+        SMD_CHK_EXCEPT_CT( ticker_t( vector< uint32_t > {} ) );
+
+        ticker_t testObject( vector< uint32_t > { 0 } );
+        SMD_CHK_EXCEPT_CT( testObject.mAdd( nullptr ) );
+        SMD_HASSERT( 0 == testObject.mcGetNumAgents() );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtLazySubtree( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtLazySubtree: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    using lazyNode_t = lazySubtreeNode_c< timeData_t >;
+
+    int  numBuilt { 0 };
+    bool isInDanger { false };
+
+    auto factory = [ &numBuilt ]() -> shared_ptr< const tree_t > {
+        ++numBuilt;
+        return builder_t()
+            .mSequence( "emergency" )
+                .mDo( "hide", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mDo( "wait-for-help", []( timeData_t timeData ) {
+                    return timeData > 0.5f ? status_t::SUCCESS : status_t::RUNNING;
+                } )
+            .mEnd()
+            .mBuild();
+    };
+
+    auto makeTree = [ & ]( uint32_t stateCapacity ) -> shared_ptr< const tree_t > {
+        return builder_t()
+            .mSequence( "agent" )
+                .mCondition( "is-in-danger", [ &isInDanger ]( timeData_t ) { return isInDanger; } )
+                .mSpliceLazy( "emergency", factory, stateCapacity )
+            .mEnd()
+            .mBuild();
+    };
+
+    testName = "Builds the sub-tree once when it's ticked for the first time";
+    {
+        numBuilt   = 0;
+        isInDanger = false;
+
+        shared_ptr< const tree_t > pTree { makeTree( 64 ) };
+        const lazyNode_t&          cLazy { static_cast< const lazyNode_t& >( *pTree->mcFind( "agent/emergency" ) ) };
+        vector< instance_t >       instances( 3, instance_t( pTree ) );
+
+        SMD_HASSERT( nodeKind_t::LAZY_SUBTREE == cLazy.mcKind && !cLazy.mcIsParent() );
+        SMD_HASSERT( 64 == cLazy.mcStateSize );
+
+        SMD_HASSERT( status_t::FAILURE == instances[ 0 ].mTick( 0.1f ) );
+        SMD_HASSERT( 0 == numBuilt && !cLazy.mcIsBuilt() );
+
+        isInDanger = true;
+        for ( auto& instance : instances ) {
+            SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        }
+        SMD_HASSERT( 1 == numBuilt && cLazy.mcIsBuilt() );
+
+        SMD_HASSERT( status_t::SUCCESS == instances[ 0 ].mTick( 1.0f ) );
+        SMD_HASSERT( 1 == numBuilt );
+    }
+    testPassed();
+
+    testName = "Releases an idle sub-tree and continues where the agent was";
+    {
+        numBuilt   = 0;
+        isInDanger = true;
+
+        shared_ptr< const tree_t > pTree { makeTree( 64 ) };
+        const lazyNode_t&          cLazy { static_cast< const lazyNode_t& >( *pTree->mcFind( "agent/emergency" ) ) };
+        instance_t                 instance( pTree );
+
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        SMD_HASSERT( 0 == releaseIdleSubtrees( *pTree ) );
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        SMD_HASSERT( 0 == releaseIdleSubtrees( *pTree ) );
+        SMD_HASSERT( 1 == releaseIdleSubtrees( *pTree ) && !cLazy.mcIsBuilt() );
+        SMD_HASSERT( 0 == releaseIdleSubtrees( *pTree ) );
+
+        SMD_HASSERT( status_t::SUCCESS == instance.mTick( 1.0f ) );
+        SMD_HASSERT( 2 == numBuilt && cLazy.mcIsBuilt() );
+    }
+    testPassed();
+
+    testName = "A sub-tree that doesn't fit the capacity fails";
+    {
+        numBuilt   = 0;
+        isInDanger = true;
+
+        instance_t instance( makeTree( 1 ) );
+
+        SMD_HASSERT( status_t::FAILURE == instance.mTick( 0.1f ) );
+        SMD_HASSERT( status_t::FAILURE == instance.mTick( 0.1f ) );
+        SMD_HASSERT( 1 == numBuilt );
+    }
+    testPassed();
+
+    testName = "Reports a sub-tree that can't be built when asked to build it";
+    {
+        numBuilt = 0;
+
+        shared_ptr< const tree_t > pTree { makeTree( 1 ) };
+        const lazyNode_t&          cLazy { static_cast< const lazyNode_t& >( *pTree->mcFind( "agent/emergency" ) ) };
+
+        SMD_CHK_EXCEPT_CT( buildLazySubtrees( *pTree ) );
+        SMD_CHK_EXCEPT_CT( cLazy.mcBuild() );
+        SMD_HASSERT( 1 == numBuilt );
+
+        shared_ptr< const tree_t > pFits { makeTree( 64 ) };
+
+        buildLazySubtrees( *pFits );
+        SMD_HASSERT( 2 == numBuilt && static_cast< const lazyNode_t& >( *pFits->mcFind( "agent/emergency" ) ).mcIsBuilt() );
+        SMD_HASSERT( 1 == releaseIdleSubtrees( *pFits ) );
+    }
+    testPassed();
+
+    testName = "A factory that throws fails the ticks until it builds the sub-tree";
+    {
+        numBuilt   = 0;
+        isInDanger = true;
+
+        uint32_t numThrown { 0 };
+
+        shared_ptr< const tree_t > pTree = builder_t()
+            .mSequence( "agent" )
+                .mSpliceLazy( "emergency", [ & ]() -> shared_ptr< const tree_t > {
+                    if ( numThrown < 3 ) {
+                        ++numThrown;
+                        throw runtime_error( "no emergency" );
+                    }
+
+                    return factory();
+                }, 64 )
+            .mEnd()
+            .mBuild();
+
+        instance_t instance( pTree );
+
+        SMD_HASSERT( status_t::FAILURE == instance.mTick( 0.1f ) );
+        SMD_HASSERT( status_t::FAILURE == instance.mTick( 0.1f ) );
+        SMD_CHK_EXCEPT_CT( buildLazySubtrees( *pTree ) );
+        SMD_HASSERT( 3 == numThrown && 0 == numBuilt );
+
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f ) );
+        SMD_HASSERT( 1 == numBuilt );
+    }
+    testPassed();
+
+    testName = "Resumes and slices ticks through the lazy sub-tree as a leaf";
+    {
+        numBuilt   = 0;
+        isInDanger = true;
+
+        auto pTree = builder_t()
+            .mSequence( "agent" )
+                .mCondition( "is-in-danger", [ &isInDanger ]( timeData_t ) { return isInDanger; } )
+                .mSpliceLazy( "emergency", factory, 64 )
+            .mEnd()
+            .mBuild();
+        pTree->mSetMemory( true );
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.1f ) );
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 1.0f ) );
+
+        instance_t   instance( move( pTree ) );
+        tickBudget_t budget;
+        budget.numVisits = 0;
+
+        SMD_HASSERT( status_t::RUNNING == instance.mTick( 0.1f, budget ) && instance.mcIsSuspended() );
+        SMD_HASSERT( status_t::SUCCESS == instance.mTick( 1.0f, budget ) && !instance.mcIsSuspended() );
+        SMD_HASSERT( 1 == numBuilt );
+    }
+    testPassed();
+
+    testName = "Cant create a lazy sub-tree without a factory or generate code for it";
+    {
+        SMD_CHK_EXCEPT_CT( lazyNode_t( "emergency", nullptr, 64 ) );
+        SMD_CHK_EXCEPT_CT( codegen_c< timeData_t >().mEmit( *makeTree( 64 )->mcGetRoot(), "tickTree" ) );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtImage( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtImage: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    using image_t = image_c< timeData_t >;
+
+    const string   cPath { "fbt-check.image" };
+    vector< string > log;
+    bool             isEnemyVisible { false };
+
+    auto act = [ &log ]( const char* cpName, status_t status ) {
+        return [ &log, cpName, status ]( timeData_t ) { log.emplace_back( cpName ); return status; };
+    };
+    auto see = [ &log, &isEnemyVisible ]( timeData_t ) { log.emplace_back( "is-enemy-visible" ); return isEnemyVisible; };
+    auto buildEmergency = []{
+        return shared_ptr< const tree_t >( builder_t()
+            .mSequence( "emergency" ).mDo( "hide", []( timeData_t ) { return status_t::RUNNING; } ).mEnd()
+            .mBuild() );
+    };
+
+    shared_ptr< const tree_t > pFlee = builder_t()
+        .mSequence( "flee" )
+            .mDo( "run", act( "run", status_t::FAILURE ) )
+        .mEnd()
+        .mBuild();
+
+    auto pTree = builder_t()
+        .mSelector( "agent" )
+            .mReactiveSelector( "combat" )
+                .mSequence( "attack" )
+                    .mCondition( "is-enemy-visible", see )
+                    .mDo( "shoot", act( "shoot", status_t::RUNNING ) )
+                .mEnd()
+                .mInverter( "not" )
+                    .mDo( "reload", act( "reload", status_t::SUCCESS ) )
+                .mEnd()
+            .mEnd()
+            .mSplice( pFlee )
+            .mSplice( pFlee )
+            .mParallel( "idle", 1, 2 )
+                .mDo( "look", act( "look", status_t::RUNNING ) )
+                .mWait( "alarm", 7 )
+            .mEnd()
+            .mSpliceLazy( "emergency", buildEmergency, 64 )
+        .mEnd()
+        .mBuild();
+    pTree->mSetMemory( true );
+
+    image_t image;
+    image
+        .mDo( "shoot", act( "shoot", status_t::RUNNING ) )
+        .mDo( "reload", act( "reload", status_t::SUCCESS ) )
+        .mDo( "run", act( "run", status_t::FAILURE ) )
+        .mDo( "look", act( "look", status_t::RUNNING ) )
+        .mCondition( "is-enemy-visible", see )
+        .mSpliceLazy( "emergency", buildEmergency );
+
+    auto describe = []( const tree_t& cTree ) {
+        string description;
+
+        cTree.mcGetRoot()->mcVisit( [ &description ]( const node_i< timeData_t >& cNode, uint32_t depth ) {
+            description += to_string( depth ) + ":" + to_string( static_cast< uint32_t >( cNode.mcKind ) ) + ":" + cNode.mcName +
+                           ":" + to_string( cNode.mcGetStateOffset() ) + ":" + to_string( cNode.mcStateSize ) + ";";
+            return true;
+        } );
+
+        return description;
+    };
+
+    testName = "A loaded image has the structure and state layout of the saved tree";
+    {
+        image_t::mSave( *pTree, cPath );
+        auto pLoaded = image.mcLoad( cPath );
+        std::remove( cPath.c_str() );
+
+        SMD_HASSERT( describe( *pTree ) == describe( *pLoaded ) );
+        SMD_HASSERT( pTree->mcGetStateSize() == pLoaded->mcGetStateSize() );
+        SMD_HASSERT( pLoaded->mcHasMemory() );
+
+        const auto& cFirst  = static_cast< const subtreeNode_c< timeData_t >& >( *pLoaded->mcGetRoot()->mcGetChild( 1 ) );
+        const auto& cSecond = static_cast< const subtreeNode_c< timeData_t >& >( *pLoaded->mcGetRoot()->mcGetChild( 2 ) );
+        SMD_HASSERT( &cFirst.mcGetTree() == &cSecond.mcGetTree() );
+        SMD_HASSERT( image_t::mFlatten( *pTree ) == image_t::mFlatten( *pLoaded ) );
+    }
+    testPassed();
+
+    testName = "A loaded image ticks as the saved tree";
+    {
+        const vector< uint8_t > cFlat { image_t::mFlatten( *pTree ) };
+
+        instance_t original( shared_ptr< const tree_t >( move( pTree ) ) );
+        instance_t loaded( image.mcInstantiate( cFlat.data(), cFlat.size() ) );
+
+        for ( bool isVisible : { false, true, true, false } ) {
+            isEnemyVisible = isVisible;
+
+            log.clear();
+            const status_t cStatus { original.mTick( 0.1f ) };
+            const vector< string > cExpected { log };
+
+            log.clear();
+            SMD_HASSERT( cStatus == loaded.mTick( 0.1f ) );
+            SMD_HASSERT( cExpected == log );
+            SMD_HASSERT( 0 == memcmp( original.mcGetState(), loaded.mcGetState(), original.mcGetStateSize() ) );
+        }
+    }
+    testPassed();
+
+    testName = "Cant load an image with unbound leaves or a corrupt image";
+    {
+        auto pSmall = builder_t()
+            .mSequence( "agent" )
+                .mDo( "shoot", act( "shoot", status_t::RUNNING ) )
+                .mCondition( "is-enemy-visible", see )
+            .mEnd()
+            .mBuild();
+
+        vector< uint8_t > flat { image_t::mFlatten( *pSmall ) };
+        SMD_HASSERT( image.mcInstantiate( flat.data(), flat.size() ) );
+        SMD_CHK_EXCEPT_CT( image_t().mDo( "shoot", act( "shoot", status_t::RUNNING ) ).mcInstantiate( flat.data(), flat.size() ) );
+        SMD_CHK_EXCEPT_CT( image_t().mCondition( "shoot", see ).mCondition( "is-enemy-visible", see )
+                                    .mcInstantiate( flat.data(), flat.size() ) );
+        SMD_CHK_EXCEPT_CT( image.mcInstantiate( flat.data(), flat.size() - 1 ) );
+        SMD_CHK_EXCEPT_CT( image.mcInstantiate( flat.data(), 4 ) );
+
+        vector< uint8_t > corrupt { flat };
+        corrupt[ 0 ] ^= 0xFF;
+        SMD_CHK_EXCEPT_CT( image.mcInstantiate( corrupt.data(), corrupt.size() ) );
+
+        // Header of 6 words, the tree record of 3 words, 3 node records of 7 words and the child list of the sequence.
+        const size_t cStateSize { 6 * 4 + 2 * 4 };
+        const size_t cChildren  { 6 * 4 + 3 * 4 + 3 * 7 * 4 };
+
+        corrupt = flat;
+        corrupt[ cStateSize ] ^= 0x10;
+        SMD_CHK_EXCEPT_CT( image.mcInstantiate( corrupt.data(), corrupt.size() ) );
+
+        corrupt = flat;
+        memcpy( &corrupt[ cChildren + 4 ], &corrupt[ cChildren ], 4 );
+        SMD_CHK_EXCEPT_CT( image.mcInstantiate( corrupt.data(), corrupt.size() ) );
+
+        SMD_CHK_EXCEPT_CT( image.mcLoad( "no-such.image" ) );
+        { ofstream empty( cPath ); }
+        SMD_CHK_EXCEPT_CT( image.mcLoad( cPath ) );
+        std::remove( cPath.c_str() );
+    }
+    testPassed();
+
+    testName = "Cant flatten or load trees nested deeper than the cap";
+    {
+        auto buildChain = [ &act ]( uint32_t numInverters ) {
+            builder_t builder;
+
+            for ( uint32_t iInverter = 0; iInverter < numInverters; ++iInverter ) {
+                builder.mInverter( "a" );
+            }
+            builder.mDo( "a", act( "a", status_t::SUCCESS ) );
+            for ( uint32_t iInverter = 0; iInverter < numInverters; ++iInverter ) {
+                builder.mEnd();
+            }
+
+            return builder.mBuild();
+        };
+
+        const uint32_t    cMaxInverters { image_t::cMaxDepth - 1 };
+        vector< uint8_t > flat          { image_t::mFlatten( *buildChain( cMaxInverters ) ) };
+        SMD_CHK_EXCEPT_CT( image_t::mFlatten( *buildChain( cMaxInverters + 1 ) ) );
+
+        // A chain of inverters over an action, laid out like a flattened one: the child lists are recorded from the deepest
+        // parent up. The magic, version and size of the state are taken from the flattened chain.
+        auto craftChain = [ &flat ]( uint32_t numInverters ) {
+            uint32_t header[ 9 ];
+            memcpy( header, flat.data(), sizeof( header ) );
+
+            vector< uint32_t > words { header[ 0 ], header[ 1 ], 1, numInverters + 1, numInverters, numInverters + 1,
+                                       0, 0, header[ 8 ] };
+
+            for ( uint32_t iNode = 0; iNode < numInverters; ++iNode ) {
+                const uint32_t cFirstChild { numInverters - 1 - iNode };
+
+                words.insert( words.end(), { static_cast< uint32_t >( nodeKind_t::INVERTER ), iNode, 1, cFirstChild, 1, 0, 0 } );
+            }
+            words.insert( words.end(), { static_cast< uint32_t >( nodeKind_t::ACTION ), numInverters, 1, 0, 0, 0, 0 } );
+            for ( uint32_t iChild = numInverters; iChild > 0; --iChild ) {
+                words.emplace_back( iChild );
+            }
+
+            vector< uint8_t > crafted( words.size() * sizeof( uint32_t ) );
+            memcpy( crafted.data(), words.data(), crafted.size() );
+            crafted.insert( crafted.end(), numInverters + 1, 'a' );
+
+            return crafted;
+        };
+
+        const image_t cImage { image_t().mDo( "a", act( "a", status_t::SUCCESS ) ) };
+
+        SMD_HASSERT( craftChain( cMaxInverters ) == flat );
+        SMD_HASSERT( cImage.mcInstantiate( flat.data(), flat.size() ) );
+
+        const vector< uint8_t > cDeep { craftChain( 4 * image_t::cMaxDepth ) };
+        SMD_CHK_EXCEPT_CT( cImage.mcInstantiate( cDeep.data(), cDeep.size() ) );
+    }
+    testPassed();
+
+    testName = "An edited tree is flattened only after it's compacted";
+    {
+        auto pEdited = builder_t()
+            .mSequence( "root" )
+                .mDo( "shoot", act( "shoot", status_t::RUNNING ) )
+                .mDo( "reload", act( "reload", status_t::SUCCESS ) )
+                .mDo( "look", act( "look", status_t::RUNNING ) )
+            .mEnd()
+            .mBuild();
+
+        auto& root      = static_cast< sequenceNode_t& >( *pEdited->mGetRoot() );
+        auto  pSelector = pEdited->mCreate< selectorNode_t >( "combat" );
+        pSelector->mAddChild( pEdited->mCreate< actionNode_t >( "run", act( "run", status_t::FAILURE ) ) );
+
+        pEdited->mRemoveChild( root, 0 );
+        pEdited->mInsertChild( root, 0, pSelector );
+
+        SMD_HASSERT( !pEdited->mcIsCompact() );
+        SMD_CHK_EXCEPT_CT( image_t::mFlatten( *pEdited ) );
+
+        pEdited->mCompact();
+
+        const vector< uint8_t > cFlat { image_t::mFlatten( *pEdited ) };
+        auto                    pLoaded = image.mcInstantiate( cFlat.data(), cFlat.size() );
+
+        SMD_HASSERT( describe( *pEdited ) == describe( *pLoaded ) );
+        SMD_HASSERT( pEdited->mcGetStateSize() == pLoaded->mcGetStateSize() );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtStructure( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtStructure: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    auto makeTree = []( const char* cpShoot, uint32_t numToSucceed, bool hasLook ) {
+        builder_t builder;
+        builder
+            .mSelector( "agent" )
+                .mSequence( "attack" )
+                    .mCondition( "is-enemy-visible", []( timeData_t ) { return true; } )
+                    .mDo( cpShoot, []( timeData_t ) { return status_t::RUNNING; } )
+                .mEnd()
+                .mParallel( "idle", 1, numToSucceed )
+                    .mWait( "alarm", 7 )
+                    .mDo( "patrol", []( timeData_t ) { return status_t::RUNNING; } );
+        if ( hasLook ) {
+            builder.mDo( "look", []( timeData_t ) { return status_t::RUNNING; } );
+        }
+
+        return shared_ptr< tree_t >( builder.mEnd().mEnd().mBuild() );
+    };
+
+    testName = "Trees built from the same description hash the same";
+    {
+        auto pA = makeTree( "shoot", 2, false );
+        auto pB = makeTree( "shoot", 2, false );
+
+        SMD_HASSERT( structuralHash( *pA ) == structuralHash( *pB ) );
+        SMD_HASSERT( structuralHash( *pA->mcGetRoot() ) == structuralHash( *pB->mcGetRoot() ) );
+        SMD_HASSERT( diffTrees( *pA->mcGetRoot(), *pB->mcGetRoot() ).empty() );
+
+        SMD_HASSERT( structuralHash( *pA ) != structuralHash( *makeTree( "aim", 2, false ) ) );
+        SMD_HASSERT( structuralHash( *pA ) != structuralHash( *makeTree( "shoot", 1, false ) ) );
+        SMD_HASSERT( structuralHash( *pA ) != structuralHash( *makeTree( "shoot", 2, true ) ) );
+
+        pB->mSetMemory( true );
+        SMD_HASSERT( structuralHash( *pA ) != structuralHash( *pB ) );
+        SMD_HASSERT( structuralHash( *pA->mcGetRoot() ) == structuralHash( *pB->mcGetRoot() ) );
+    }
+    testPassed();
+
+    testName = "Diff reports changed, added and removed nodes";
+    {
+        auto pA = makeTree( "shoot", 2, false );
+
+        vector< treeChange_t > changes { diffTrees( *pA->mcGetRoot(), *makeTree( "aim", 1, true )->mcGetRoot() ) };
+
+        SMD_HASSERT( 3 == changes.size() );
+        SMD_HASSERT( change_t::CHANGED == changes[ 0 ].change && "agent/attack/shoot" == changes[ 0 ].path );
+        SMD_HASSERT( change_t::CHANGED == changes[ 1 ].change && "agent/idle" == changes[ 1 ].path );
+        SMD_HASSERT( change_t::ADDED == changes[ 2 ].change && "agent/idle/look" == changes[ 2 ].path );
+
+        changes = diffTrees( *makeTree( "shoot", 2, true )->mcGetRoot(), *pA->mcGetRoot() );
+
+        SMD_HASSERT( 1 == changes.size() );
+        SMD_HASSERT( change_t::REMOVED == changes[ 0 ].change && "agent/idle/look" == changes[ 0 ].path );
+    }
+    testPassed();
+
+    testName = "Interning shares structurally identical trees";
+    {
+        library_t testObject;
+
+        shared_ptr< const tree_t > pA { testObject.mIntern( makeTree( "shoot", 2, false ) ) };
+        shared_ptr< const tree_t > pB { testObject.mIntern( makeTree( "shoot", 2, false ) ) };
+        shared_ptr< const tree_t > pC { testObject.mIntern( makeTree( "shoot", 2, true ) ) };
+
+        auto pWithMemory = makeTree( "shoot", 2, false );
+        pWithMemory->mSetMemory( true );
+        shared_ptr< const tree_t > pD { testObject.mIntern( pWithMemory ) };
+
+        SMD_HASSERT( pA == pB && pA != pC && pA != pD );
+        SMD_HASSERT( 3 == testObject.mcGetNumInterned() && 0 == testObject.mcGetNumTrees() );
+        SMD_CHK_EXCEPT_CT( testObject.mIntern( nullptr ) );
+    }
+    testPassed();
+
+    testName = "Interning doesnt share leaves of the same names that run other functions";
+    {
+        struct leaves_t final {
+            static status_t mShoot( timeData_t ) { return status_t::SUCCESS; }
+            static status_t mMiss( timeData_t )  { return status_t::FAILURE; }
+        };
+
+        auto makeLeaf = []( status_t ( *pFunction )( timeData_t ) ) {
+            return shared_ptr< tree_t >( builder_t().mSequence( "attack" ).mDo( "shoot", pFunction ).mEnd().mBuild() );
+        };
+        auto makeLambda = []( bool isHit ) {
+            builder_t builder;
+            builder.mSequence( "attack" );
+
+            if ( isHit ) {
+                builder.mDo( "shoot", []( timeData_t ) { return status_t::SUCCESS; } );
+            } else {
+                builder.mDo( "shoot", []( timeData_t ) { return status_t::FAILURE; } );
+            }
+
+            return shared_ptr< tree_t >( builder.mEnd().mBuild() );
+        };
+
+        library_t testObject;
+
+        shared_ptr< const tree_t > pA { testObject.mIntern( makeLeaf( &leaves_t::mShoot ) ) };
+        shared_ptr< const tree_t > pB { testObject.mIntern( makeLeaf( &leaves_t::mMiss ) ) };
+        shared_ptr< const tree_t > pC { testObject.mIntern( makeLambda( true ) ) };
+        shared_ptr< const tree_t > pD { testObject.mIntern( makeLambda( false ) ) };
+
+        SMD_HASSERT( structuralHash( *pA ) == structuralHash( *pD ) );
+        SMD_HASSERT( pA != pB && pA != pC && pB != pC && pC != pD );
+        SMD_HASSERT( pA == testObject.mIntern( makeLeaf( &leaves_t::mShoot ) ) );
+        SMD_HASSERT( pD == testObject.mIntern( makeLambda( false ) ) );
+        SMD_HASSERT( 4 == testObject.mcGetNumInterned() );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtGuardSharing( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtGuardSharing: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    uint32_t numHasTarget { 0 };
+    uint32_t numIsHungry  { 0 };
+
+    auto hasTarget = [ &numHasTarget ]( timeData_t ) { ++numHasTarget; return false; };
+    auto isHungry  = [ &numIsHungry ]( timeData_t ) { ++numIsHungry; return false; };
+
+    auto makeTree = [ & ]( bool isShared ) {
+        auto pTree = shared_ptr< tree_t >( builder_t()
+            .mSelector( "agent" )
+                .mSequence( "attack" )
+                    .mSharedCondition( "has-target", hasTarget )
+                    .mDo( "shoot", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+                .mSequence( "chase" )
+                    .mSharedCondition( "has-target", hasTarget )
+                    .mDo( "run", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+                .mSequence( "eat" )
+                    .mSharedCondition( "is-hungry", isHungry )
+                    .mDo( "chew", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+                .mDo( "idle", []( timeData_t ) { return status_t::RUNNING; } )
+            .mEnd()
+            .mBuild() );
+        pTree->mSetGuardSharing( isShared );
+
+        return pTree;
+    };
+
+    testName = "Guards aren't shared by default";
+    {
+        auto pTree = makeTree( false );
+
+        numHasTarget = numIsHungry = 0;
+
+        SMD_HASSERT( !tree_t().mcSharesGuards() );
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.0f ) );
+        SMD_HASSERT( 2 == numHasTarget && 1 == numIsHungry );
+    }
+    testPassed();
+
+    testName = "A shared condition is evaluated once per tick";
+    {
+        auto pTree = makeTree( true );
+
+        numHasTarget = numIsHungry = 0;
+
+        SMD_HASSERT( pTree->mcSharesGuards() );
+        SMD_HASSERT( pTree->mcGetStateSize() > makeTree( false )->mcGetStateSize() );
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.0f ) );
+        SMD_HASSERT( 1 == numHasTarget && 1 == numIsHungry );
+
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.0f ) );
+        SMD_HASSERT( 2 == numHasTarget && 2 == numIsHungry );
+    }
+    testPassed();
+
+    testName = "Every instance caches its own results";
+    {
+        auto pTree = makeTree( true );
+
+        instance_t testObject1( pTree );
+        instance_t testObject2( pTree );
+
+        numHasTarget = 0;
+
+        testObject1.mTick( 0.0f );
+        testObject2.mTick( 0.0f );
+        testObject1.mTick( 0.0f );
+        SMD_HASSERT( 3 == numHasTarget );
+
+        vector< stateWord_t > snapshot( testObject1.mcGetNumWords() );
+        testObject1.mcSnapshot( snapshot.data() );
+        testObject1.mTick( 0.0f );
+        testObject1.mRestore( snapshot.data() );
+        testObject1.mTick( 0.0f );
+        SMD_HASSERT( 5 == numHasTarget );
+
+        testObject1.mReset();
+        testObject1.mTick( 0.0f );
+        SMD_HASSERT( 6 == numHasTarget );
+    }
+    testPassed();
+
+    testName = "Only shared conditions share their results";
+    {
+        bool isFirstVisible  { false };
+        bool isSecondVisible { true };
+
+        auto pTree = shared_ptr< tree_t >( builder_t()
+            .mSelector( "agent" )
+                .mSequence( "attack-first" )
+                    .mCondition( "is-visible", [ & ]( timeData_t ) { return isFirstVisible; } )
+                    .mDo( "shoot-first", []( timeData_t ) { return status_t::RUNNING; } )
+                .mEnd()
+                .mSequence( "attack-second" )
+                    .mCondition( "is-visible", [ & ]( timeData_t ) { return isSecondVisible; } )
+                    .mDo( "shoot-second", []( timeData_t ) { return status_t::SUCCESS; } )
+                .mEnd()
+            .mEnd()
+            .mBuild() );
+        pTree->mSetGuardSharing( true );
+
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 0.0f ) );
+        isFirstVisible  = true;
+        isSecondVisible = false;
+        SMD_HASSERT( status_t::RUNNING == pTree->mTick( 0.0f ) );
+
+        const auto* cpCondition = static_cast< const conditionNode_c< timeData_t >* >( pTree->mcFindByName( "is-visible" ) );
+        SMD_HASSERT( !cpCondition->mcIsShared && conditionNode_c< timeData_t >::cNoGuard == cpCondition->mcGetGuardOffset() );
+
+        // Whether a condition is shared is part of the structure and of images.
+        const vector< uint8_t > cFlat { image_c< timeData_t >::mFlatten( *makeTree( true ) ) };
+        auto pLoaded = image_c< timeData_t >()
+            .mCondition( "has-target", hasTarget )
+            .mCondition( "is-hungry", isHungry )
+            .mDo( "shoot", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mDo( "run", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mDo( "chew", []( timeData_t ) { return status_t::SUCCESS; } )
+            .mDo( "idle", []( timeData_t ) { return status_t::RUNNING; } )
+            .mcInstantiate( cFlat.data(), cFlat.size() );
+
+        SMD_HASSERT( structuralHash( *pLoaded ) == structuralHash( *makeTree( true ) ) );
+        SMD_HASSERT( static_cast< const conditionNode_c< timeData_t >* >( pLoaded->mcFindByName( "has-target" ) )->mcIsShared );
+        SMD_HASSERT( pLoaded->mcGetStateSize() == makeTree( true )->mcGetStateSize() );
+    }
+    testPassed();
+
+    testName = "Edits share the guards of new conditions";
+    {
+        auto pTree = makeTree( true );
+        auto& agent = static_cast< selectorNode_t& >( *pTree->mGetRoot() );
+
+        auto pFlee = pTree->mCreate< sequenceNode_t >( "flee" );
+        pFlee->mAddChild( pTree->mCreate< conditionNode_c< timeData_t > >( "has-target", hasTarget, true ) );
+        pFlee->mAddChild( pTree->mCreate< actionNode_t >( "hide", []( timeData_t ) { return status_t::SUCCESS; } ) );
+        pTree->mInsertChild( agent, 2, pFlee );
+
+        instance_t testObject( pTree );
+
+        numHasTarget = 0;
+
+        pTree->mTick( 0.0f );
+        testObject.mTick( 0.0f );
+        SMD_HASSERT( 2 == numHasTarget );
+
+        pTree->mSetGuardSharing( false );
+        testObject.mSync();
+        testObject.mTick( 0.0f );
+        SMD_HASSERT( 5 == numHasTarget );
+    }
+    testPassed();
+
+    testName = "Conditions destroyed before they were attached dont count as uses of the guard";
+    {
+        auto pTree = makeTree( true );
+        auto& agent = static_cast< selectorNode_t& >( *pTree->mGetRoot() );
+
+        auto pLost = pTree->mCreate< conditionNode_c< timeData_t > >( "is-hungry", isHungry, true );
+        SMD_CHK_EXCEPT_CT( pTree->mReplaceChild( agent, 9, pLost ) );
+
+        auto pEat = pTree->mCreate< sequenceNode_t >( "eat-more" );
+        pEat->mAddChild( pTree->mCreate< conditionNode_c< timeData_t > >( "is-hungry", isHungry, true ) );
+        pEat->mAddChild( pTree->mCreate< actionNode_t >( "chew-more", []( timeData_t ) { return status_t::SUCCESS; } ) );
+        pTree->mInsertChild( agent, 3, pEat );
+
+        numIsHungry = 0;
+        pTree->mTick( 0.0f );
+        SMD_HASSERT( 1 == numIsHungry );
+    }
+    testPassed();
+}
+
+//==============================================================================================================================
+void check_fbtScratch( void ) {
+    string testName;
+
+    auto testPassed = [ &testName ]{
+        cout << setw( 100 ) << ( "check_fbtScratch: " + testName + ": " ) << " PASSED" << endl;
+    };
+
+    using context_t = tickContext_t< timeData_t >;
+    using list_t    = vector< uint32_t, scratchAllocator_c< uint32_t > >;
+
+    testName = "Rewinding reuses the memory and merges the blocks";
+    {
+        scratch_c testObject( 256 );
+
+        const scratch_c::mark_t cStart { testObject.mcGetMark() };
+
+        void* const cpFirst { testObject.mAllocate( 1 ) };
+        SMD_HASSERT( 0 == reinterpret_cast< uintptr_t >( cpFirst ) % scratch_c::cAlign );
+        SMD_HASSERT( 0 == reinterpret_cast< uintptr_t >( testObject.mAllocate( 3 ) ) % scratch_c::cAlign );
+
+        const scratch_c::mark_t cMark { testObject.mcGetMark() };
+        void* const             cpThird { testObject.mAllocate( 8 ) };
+        testObject.mRewind( cMark );
+        SMD_HASSERT( cpThird == testObject.mAllocate( 8 ) );
+        SMD_HASSERT( 1 == testObject.mcGetNumBlocks() );
+
+        testObject.mAllocate( 220 );
+        testObject.mAllocate( 1000 );
+        SMD_HASSERT( 3 == testObject.mcGetNumBlocks() );
+
+        const size_t cCapacity { testObject.mcGetCapacity() };
+        testObject.mRewind( cStart );
+        SMD_HASSERT( 0 == testObject.mcGetNumBlocks() );
+
+        testObject.mAllocate( 16 );
+        testObject.mAllocate( 200 );
+        testObject.mAllocate( 1000 );
+        SMD_HASSERT( 1 == testObject.mcGetNumBlocks() && cCapacity == testObject.mcGetCapacity() );
+    }
+    testPassed();
+
+    void* pBuffer { nullptr };
+
+    auto findTargets = [ &pBuffer ]( const context_t& cContext ) {
+        list_t targets { scratchAllocator_c< uint32_t >( *cContext.pScratch ) };
+        for ( uint32_t iTarget = 0; iTarget < 100; ++iTarget ) {
+            targets.push_back( iTarget );
+        }
+        pBuffer = targets.data();
+
+        return 4950 == std::accumulate( targets.begin(), targets.end(), 0u ) ? status_t::SUCCESS : status_t::FAILURE;
+    };
+
+    auto pTree = shared_ptr< tree_t >( builder_t()
+        .mSequence( "agent" )
+            .mDo( "find-targets", findTargets )
+        .mEnd()
+        .mBuild() );
+
+    testName = "A tick rewinds the scratch of the thread when it returns";
+    {
+        scratch_c& scratch { scratch_c::mGetThreadScratch() };
+
+        SMD_HASSERT( status_t::SUCCESS == pTree->mTick( 0.0f ) );
+        SMD_HASSERT( 0 == scratch.mcGetMark().iBlock && 0 == scratch.mcGetMark().offset );
+
+        void* const cpPrevious { pBuffer };
+        const size_t cNumBlocks { scratch.mcGetNumBlocks() };
+
+        instance_t testObject( pTree );
+        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( 0.0f ) );
+        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( 0.0f, tickBudget_t {} ) );
+        SMD_HASSERT( cpPrevious == pBuffer && cNumBlocks == scratch.mcGetNumBlocks() );
+        SMD_HASSERT( 0 == scratch.mcGetMark().iBlock && 0 == scratch.mcGetMark().offset );
+    }
+    testPassed();
+
+    testName = "The caller may set its own scratch";
+    {
+        scratch_c  scratch;
+        instance_t testObject( pTree );
+        context_t  context { 0.0f, nullptr };
+
+        context.pScratch = &scratch;
+
+        SMD_HASSERT( status_t::SUCCESS == testObject.mTick( context ) );
+        SMD_HASSERT( &scratch == context.pScratch && 1 == scratch.mcGetNumBlocks() );
+        SMD_HASSERT( 0 == scratch.mcGetMark().iBlock && 0 == scratch.mcGetMark().offset );
+
+        context.pScratch = nullptr;
+        testObject.mTick( context );
+        SMD_HASSERT( nullptr == context.pScratch );
+    }
+    testPassed();
+
+    testName = "Nested ticks only rewind their own memory";
+    {
+        instance_t inner( pTree );
+        bool       isIntact { false };
+
+        auto pOuter = shared_ptr< tree_t >( builder_t()
+            .mSequence( "agent" )
+                .mDo( "plan", [ &inner, &isIntact, &pBuffer ]( const context_t& cContext ) {
+                    list_t plan( 10, 7, scratchAllocator_c< uint32_t >( *cContext.pScratch ) );
+
+                    const scratch_c::mark_t cMark { cContext.pScratch->mcGetMark() };
+                    inner.mTick( 0.0f );
+                    isIntact = cMark.offset == cContext.pScratch->mcGetMark().offset && pBuffer != plan.data();
+
+                    plan.push_back( 7 );
+                    isIntact = isIntact && 77 == std::accumulate( plan.begin(), plan.end(), 0u );
+
+                    return status_t::SUCCESS;
+                } )
+            .mEnd()
+            .mBuild() );
+
+        SMD_HASSERT( status_t::SUCCESS == pOuter->mTick( 0.0f ) );
+        SMD_HASSERT( isIntact );
+    }
+    testPassed();
+}
+
 //==============================================================================================================================
 int main( void ) try {
     cout << left << setfill( '.' );
 
-    check_fbtActionNode();   cout << endl;
-    check_fbtInverterNode(); cout << endl;
-    check_fbtParallelNode(); cout << endl;
-    check_fbtSelectorNode(); cout << endl;
-    check_fbtSequenceNode(); cout << endl;
-    check_fbtBuilder();
+    check_fbtActionNode();        cout << endl;
+    check_fbtBatchCondition();    cout << endl;
+    check_fbtStatusLanes();       cout << endl;
+    check_fbtInverterNode();      cout << endl;
+    check_fbtParallelNode();      cout << endl;
+    check_fbtSelectorNode();      cout << endl;
+    check_fbtSequenceNode();      cout << endl;
+    check_fbtBuilder();           cout << endl;
+    check_fbtOptimizer();         cout << endl;
+    check_fbtCodegen();           cout << endl;
+    check_fbtLibrary();           cout << endl;
+    check_fbtSnapshot();          cout << endl;
+    check_fbtParallelTicker();    cout << endl;
+    check_fbtProfiler();          cout << endl;
+    check_fbtMutation();          cout << endl;
+    check_fbtNodeIndex();         cout << endl;
+    check_fbtTraversal();         cout << endl;
+    check_fbtReactiveSelector();  cout << endl;
+    check_fbtTickContext();       cout << endl;
+    check_fbtActivePath();        cout << endl;
+    check_fbtScheduler();         cout << endl;
+    check_fbtTimeSlice();         cout << endl;
+    check_fbtPartitionedTicker(); cout << endl;
+    check_fbtLazySubtree();       cout << endl;
+    check_fbtImage();             cout << endl;
+    check_fbtStructure();         cout << endl;
+    check_fbtGuardSharing();      cout << endl;
+    check_fbtScratch();
 
     return 0;
 